@@ -21,6 +21,7 @@
  * 
  */
 
+#include <iostream>
 #include "adaptivesystem.h"
 
 /**
@@ -75,50 +76,111 @@ AdaptiveSystem::AdaptiveSystem() { }
 AdaptiveSystem::~AdaptiveSystem() { }
 
 /**
- * Initialises the local topology representation.
+ * Finds the best paths of many source and destination pairs.
+ *
+ * @param pairs The source and destination pairs
+ * @return std::vector<std::vector<int>> The best path of every pair
+ */
+std::vector<std::vector<int>> AdaptiveSystem::paths(
+		std::span<const std::pair<int, int>> pairs)
+{
+	std::vector<std::vector<int>> bestPaths;
+	bestPaths.reserve(pairs.size());
+	for(auto& pair : pairs)
+		bestPaths.push_back(path(pair.first, pair.second));
+
+	return bestPaths;
+}
+
+/**
+ * Initialises the local topology representation. The file is parsed in a 
+ * single pass and every link is inserted as soon as it is read.
  * 
- * @param filename JSON-formatted file containing the topology representation
+ * @param filename JSON-formatted file or binary snapshot containing the 
+ * topology representation
  */
 void AdaptiveSystem::initTopo(const std::string& filename)
 {
-	ptree pt;
-	boost::property_tree::read_json(filename, pt);
-	ptree::const_iterator end = pt.end();
-	for(ptree::const_iterator it = pt.begin(); it != end; ++it)
+	if(Snapshot::probe(filename))
 	{
-		if(!std::strcmp(it->first.c_str(), "number_of_nodes"))
-			continue;
+		initSnapshot(Snapshot(filename));
+		return;
+	}
 
-		ptree::const_iterator end2 = it->second.end();
-		for(ptree::const_iterator it2 = it->second.begin(); it2 != end2; ++it2)
-		{
-			ptree::const_iterator end3 = it2->second.end();
-			int src = 0; int dest = 0; int length = 0;
-			for(ptree::const_iterator it3 = it2->second.begin(); it3 != end3; ++it3)
-			{
-				if(!std::strcmp(it3->first.c_str(), "nodes"))
-				{
-					int index = 0;
-					ptree::const_iterator end31 = it3->second.end();
-					for(ptree::const_iterator it31 = it3->second.begin(); it31 != end31; ++it31, ++index)
-					{
-						if(index == 0)
-							src = it31->second.get_value<int>();
-						if(index == 1)
-							dest = it31->second.get_value<int>();
-					}
-				}
-				if(!std::strcmp(it3->first.c_str(), "length"))
-					length = it3->second.get_value<int>();
-			}
+	TopologyReader reader(filename);
+	reader.read([this](int nodes) { reserveNodes(nodes); },
+			[this](int src, int dest, double length) { insertEdge(src, dest, length); });
+}
 
-			insertEdge(src, dest, static_cast<double>(length));
-		}
+/**
+ * Initialises the local topology representation from a binary snapshot.
+ * 
+ * @param snapshot The memory-mapped snapshot
+ */
+void AdaptiveSystem::initSnapshot(const Snapshot& snapshot)
+{
+	reserveNodes(snapshot.nodes());
+	edges.reserve(edges.size() + snapshot.edges());
+	const std::int64_t* offsets = snapshot.offsets();
+	for(int node = 0; node < snapshot.nodes(); ++node)
+		for(std::int64_t edge = offsets[node]; edge < offsets[node + 1]; ++edge)
+			insertEdge(node, snapshot.targets()[edge], snapshot.weights()[edge]);
+}
+
+/**
+ * Writes the topology as a binary snapshot.
+ * 
+ * @param filename The snapshot file
+ */
+void AdaptiveSystem::saveSnapshot(const std::string& filename)
+{
+	int nodes = nodeCount();
+
+	// Sort the edges by starting node, keeping their order inside each row
+	std::vector<std::int64_t> offsets(nodes + 1, 0);
+	for(auto& edge : edges)
+		++offsets[edge.edgeStart + 1];
+	for(int node = 0; node < nodes; ++node)
+		offsets[node + 1] += offsets[node];
+
+	std::vector<std::int64_t> next(offsets.begin(), offsets.end() - 1);
+	std::vector<std::int32_t> targets(edges.size());
+	std::vector<double> weights(edges.size());
+	for(auto& edge : edges)
+	{
+		std::int64_t pos = next[edge.edgeStart]++;
+		targets[pos] = edge.edgeEnd;
+		weights[pos] = edge.weight;
 	}
+
+	Snapshot::write(filename, offsets, targets, weights);
 }
 
 /**
- * Inserts an edge.
+ * Hint about the number of nodes before edges are inserted.
+ *
+ * @param nodes Expected number of nodes
+ */
+void AdaptiveSystem::reserveNodes(int nodes) { }
+
+/**
+ * Returns the number of nodes, which is derived from the edges unless an 
+ * implementation keeps the nodes without edges as well.
+ *
+ * @return int Number of nodes
+ */
+int AdaptiveSystem::nodeCount() const
+{
+	int nodes = 0;
+	for(auto& edge : edges)
+		nodes = std::max(nodes, std::max(edge.edgeStart, edge.edgeEnd) + 1);
+
+	return nodes;
+}
+
+/**
+ * Inserts an edge. Its ID is its dense index inside the edges of this 
+ * instance.
  * 
  * @param src Starting node
  * @param dest Ending node
@@ -126,15 +188,133 @@ void AdaptiveSystem::initTopo(const std::string& filename)
  */
 void AdaptiveSystem::insertEdge(int src, int dest, double weight) noexcept(false)
 {
+	checkNodes(src, dest);
 	AdaptiveSystem::Edge edge;
 	edge.edgeStart = src;
 	edge.edgeEnd = dest;
 	edge.weight = weight;
-	edge.id = ++edgeIdCnt;
+	edge.id = static_cast<long int>(edges.size());
 	edges.push_back(edge);
 }
 
 /**
- * Used for producing edge IDs.
+ * Removes an edge.
+ * 
+ * @param src Starting node
+ * @param dest Ending node
+ * @return bool The indication of an existing edge being removed
+ */
+bool AdaptiveSystem::removeEdge(int src, int dest)
+{
+	checkNodes(src, dest);
+	auto it = std::find_if(edges.begin(), edges.end(), [src, dest](const Edge& edge)
+			{
+				return edge.edgeStart == src && edge.edgeEnd == dest;
+			});
+	if(it == edges.end())
+		return false;
+
+	eraseEdge(static_cast<int>(it - edges.begin()));
+	return true;
+}
+
+/**
+ * Rejects the end points of an edge that are no node IDs.
+ * 
+ * @param src Starting node
+ * @param dest Ending node
+ */
+void AdaptiveSystem::checkNodes(int src, int dest) noexcept(false)
+{
+	if(src < 0 || dest < 0)
+		throw std::invalid_argument("edge " + std::to_string(src) + " -> " 
+				+ std::to_string(dest) + " has a negative node");
+}
+
+/**
+ * Erases an edge, which the last edge replaces so that IDs stay dense.
+ * 
+ * @param index The edge's index
+ */
+void AdaptiveSystem::eraseEdge(int index)
+{
+	edges[index] = edges.back();
+	edges[index].id = index;
+	edges.pop_back();
+}
+
+/**
+ * Updates the weight of an edge.
+ * 
+ * @param src Starting node
+ * @param dest Ending node
+ * @param weight New weight for the edge
+ * @return bool The indication of an existing edge being updated
+ */
+bool AdaptiveSystem::updateEdge(int src, int dest, double weight)
+{
+	checkNodes(src, dest);
+	auto it = std::find_if(edges.begin(), edges.end(), [src, dest](const Edge& edge)
+			{
+				return edge.edgeStart == src && edge.edgeEnd == dest;
+			});
+	if(it == edges.end())
+		return false;
+
+	it->weight = weight;
+	return true;
+}
+
+/**
+ * Drops the edges that repeat both end points of an earlier edge, e.g., 
+ * links listed twice in a file, so that a node has one edge per target.
+ * 
+ * @return std::vector<int> The former index of every remaining edge
  */
-int AdaptiveSystem::edgeIdCnt = 0;
+std::vector<int> AdaptiveSystem::dropDuplicates()
+{
+	int nodes = 0;
+	for(auto& edge : edges)
+		nodes = std::max(nodes, std::max(edge.edgeStart, edge.edgeEnd) + 1);
+
+	// Visit the edges row by row in insertion order, stamping every target 
+	// with the row's node
+	std::vector<int> rowStarts(nodes + 1, 0);
+	for(auto& edge : edges)
+		++rowStarts[edge.edgeStart + 1];
+	for(int node = 0; node < nodes; ++node)
+		rowStarts[node + 1] += rowStarts[node];
+	std::vector<int> order(edges.size());
+	std::vector<int> next(rowStarts.begin(), rowStarts.end() - 1);
+	for(int edge = 0; edge < (int)edges.size(); ++edge)
+		order[next[edges[edge].edgeStart]++] = edge;
+	std::vector<int> seen(nodes, -1);
+	std::vector<char> dropped(edges.size(), 0);
+	int count = 0;
+	for(int node = 0; node < nodes; ++node)
+		for(int pos = rowStarts[node]; pos < rowStarts[node + 1]; ++pos)
+		{
+			int dest = edges[order[pos]].edgeEnd;
+			if(seen[dest] == node)
+			{
+				dropped[order[pos]] = 1;
+				++count;
+			}
+			seen[dest] = node;
+		}
+
+	std::vector<int> kept;
+	kept.reserve(edges.size() - count);
+	for(int edge = 0; edge < (int)edges.size(); ++edge)
+		if(!dropped[edge])
+		{
+			edges[kept.size()] = edges[edge];
+			edges[kept.size()].id = static_cast<long int>(kept.size());
+			kept.push_back(edge);
+		}
+	edges.resize(kept.size());
+	if(count > 0)
+		std::cerr << count << " duplicate edges ignored" << std::endl;
+
+	return kept;
+}
@@ -25,12 +25,13 @@
 #define ADAPTIVESYSTEM_H
 
 #include <functional>
+#include <algorithm>
 #include <vector>
 #include <string>
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/json_parser.hpp>
-
-using boost::property_tree::ptree;
+#include <span>
+#include <utility>
+#include "topologyreader.h"
+#include "snapshot.h"
 
 class AdaptiveSystem
 {
@@ -50,15 +51,23 @@ public:
 	AdaptiveSystem();
 	virtual ~AdaptiveSystem();
 	virtual std::vector<int> path(int, int) = 0;
+	virtual std::vector<std::vector<int>> paths(std::span<const std::pair<int, int>>);
 	virtual void insertEdge(int, int, double) noexcept(false);
+	virtual bool removeEdge(int, int);
+	virtual bool updateEdge(int, int, double);
+	virtual void saveSnapshot(const std::string&) noexcept(false);
 	virtual void clear() = 0;
 
 protected:
 	virtual void initTopo(const std::string&);
+	virtual void initSnapshot(const Snapshot&);
+	virtual void reserveNodes(int);
+	virtual int nodeCount() const;
+	static void checkNodes(int, int) noexcept(false);
+	void eraseEdge(int);
+	std::vector<int> dropDuplicates();
+	// Edge IDs are their indices, i.e., always in range [0, edges.size())
 	std::vector<Edge> edges;
-
-private:
-	static int edgeIdCnt;
 };
 
 #endif // ADAPTIVESYSTEM_H
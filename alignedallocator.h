@@ -0,0 +1,74 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ALIGNEDALLOCATOR_H
+#define ALIGNEDALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+
+/**
+ * Allocator placing containers' elements at a boundary suitable for 
+ * vector loads, by default a cache line.
+ */
+template<class T, std::size_t ALIGNMENT = 64>
+struct AlignedAllocator
+{
+	typedef T value_type;
+
+	template<class U>
+	struct rebind
+	{
+		typedef AlignedAllocator<U, ALIGNMENT> other;
+	};
+
+	AlignedAllocator() noexcept { }
+
+	template<class U>
+	AlignedAllocator(const AlignedAllocator<U, ALIGNMENT>&) noexcept { }
+
+	T* allocate(std::size_t n)
+	{
+		return static_cast<T*>(::operator new(n * sizeof(T), 
+				std::align_val_t(ALIGNMENT)));
+	}
+
+	void deallocate(T* p, std::size_t) noexcept
+	{
+		::operator delete(p, std::align_val_t(ALIGNMENT));
+	}
+
+	template<class U>
+	bool operator==(const AlignedAllocator<U, ALIGNMENT>&) const noexcept
+	{
+		return true;
+	}
+
+	template<class U>
+	bool operator!=(const AlignedAllocator<U, ALIGNMENT>&) const noexcept
+	{
+		return false;
+	}
+};
+
+#endif // ALIGNEDALLOCATOR_H
@@ -23,6 +23,57 @@
 
 #include "antsystem.h"
 
+// Header of pheromone checkpoints, followed by one record per edge
+struct CheckpointHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t order;
+	std::uint64_t records;
+};
+
+// Pheromone level of an edge, identified by its end points
+struct CheckpointRecord
+{
+	std::int32_t edgeStart;
+	std::int32_t edgeEnd;
+	double level;
+};
+
+static const char CHECKPOINT_MAGIC[8] = {'A', 'C', 'O', 'P', 'H', 'E', 'R', 'O'};
+static const std::uint32_t CHECKPOINT_VERSION = 1;
+static const std::uint32_t CHECKPOINT_ORDER = 0x01020304;
+
+/**
+ * Maps an exponent to an integer when it can be raised by multiplications.
+ *
+ * @param exp The exponent
+ * @return int The integer exponent or -1 when std::pow is needed
+ */
+static constexpr int intExponent(double exp)
+{
+	return exp >= 0 && exp <= 64 && exp == static_cast<int>(exp) 
+			? static_cast<int>(exp) : -1;
+}
+
+/**
+ * Raises to an integer power known at compile time by repeated squaring.
+ *
+ * @param base The base
+ * @return double The power
+ */
+template<int EXP>
+static double intPower(double base)
+{
+	if constexpr(EXP <= 0)
+		return 1;
+	else
+	{
+		double half = intPower<EXP / 2>(base);
+		return EXP % 2 ? half * half * base : half * half;
+	}
+}
+
 /**
  * Constructor initialising the topology from external file.
  * 
@@ -32,16 +83,25 @@
  */
 AntSystem::AntSystem(const std::string& filename, int ants, int iterations) 
 {
+	// Edges read from the file are indexed all at once
+	graph = std::make_shared<Graph>();
+	loading = true;
+	guided = false;
 	try
 	{
 		initTopo(filename);
-		for(auto& edge : edges)
-			edge2phero.insert(std::make_pair(edge, static_cast<double>(PHERO_QUANTITY)));
 	}
 	catch(std::exception& e)
 	{
 		std::cerr << e.what() << std::endl;
 	}
+	// Snapshots are indexed as they are loaded
+	if(loading)
+	{
+		loading = false;
+		dropDuplicates();
+		buildIndex();
+	}
 
 	init(ants, iterations);
 }
@@ -54,7 +114,25 @@ AntSystem::AntSystem(const std::string& filename, int ants, int iterations)
  */
 AntSystem::AntSystem(int ants, int iterations) 
 {
+	graph = std::make_shared<Graph>();
+	loading = false;
+	init(ants, iterations);
+}
+
+/**
+ * Constructor for an instance that shares a topology, holding only its 
+ * own pheromone levels. It is meant for queries, since any change to the 
+ * topology copies it first while the edges are not kept.
+ * 
+ * @param graph The shared topology
+ * @param ants Number of ants to unlease in each iteration
+ * @param iterations Number of iterations
+ */
+AntSystem::AntSystem(std::shared_ptr<Graph> graph, int ants, int iterations)
+{
+	loading = false;
 	init(ants, iterations);
+	adopt(graph);
 }
 
 /**
@@ -82,7 +160,103 @@ void AntSystem::init(int ants, int iterations)
 	}
 
 	std::random_device rd;
-	gen = std::mt19937_64(rd());
+	walkers.resize(1);
+	seed(static_cast<std::uint64_t>(rd()) << 32 | rd());
+
+	tableCapacity = 0;
+	warmIterations = 0;
+	layout = 0;
+	weightVersion = 0;
+	reverseLayout = -1;
+	landmarkLayout = -1;
+	guided = false;
+	forwardAnts = 0;
+	meetEpoch = 0;
+	checkpointInterval = std::chrono::milliseconds(0);
+	instrumented = false;
+	migrationInterval = 0;
+}
+
+/**
+ * Returns the topology for a change, after copying it when it is shared 
+ * with other instances.
+ *
+ * @return Graph& The topology owned by this instance only
+ */
+AntSystem::Graph& AntSystem::writable()
+{
+	if(graph.use_count() > 1)
+		graph = std::make_shared<Graph>(*graph);
+
+	return *graph;
+}
+
+/**
+ * Switches to another shared topology, starting over from PHERO_QUANTITY 
+ * upon all of its edges.
+ *
+ * @param graph The shared topology
+ */
+void AntSystem::adopt(const std::shared_ptr<Graph>& graph)
+{
+	if(this->graph == graph)
+		return;
+
+	this->graph = graph;
+	++layout;
+	pheros.assign(graph->targets.size(), static_cast<Level>(PHERO_QUANTITY));
+	attracts.assign(graph->targets.size(), 0);
+	aliasProbs.clear();
+	aliasIndices.clear();
+	rowSums.assign(graph->starts.size(), 0);
+	refreshAttractions();
+}
+
+/**
+ * Enables keeping the pheromone table of each destination after a query, 
+ * so that later queries to the same destination warm-start from it with a 
+ * smaller iteration budget. Queries to other destinations start from 
+ * PHERO_QUANTITY. The least recently used tables are evicted and all of 
+ * them become stale when the topology's layout changes.
+ *
+ * @param capacity Maximum number of cached tables, with 0 disabling the mode
+ * @param iterations Iterations of a warm-started query
+ */
+void AntSystem::setWarmStart(int capacity, int iterations)
+{
+	tableCapacity = std::max(0, capacity);
+	warmIterations = iterations > 0 ? iterations : this->iterations;
+	while((int)tables.size() > tableCapacity)
+		evictTable();
+}
+
+/**
+ * Sets the number of threads that construct the ants' tours of each 
+ * iteration in parallel.
+ *
+ * @param threads Number of worker threads, with 0 meaning all hardware threads
+ */
+void AntSystem::setThreads(int threads)
+{
+	if(threads <= 0)
+		threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	pool.reset(threads > 1 ? new ThreadPool(threads) : nullptr);
+	walkers.resize(threads);
+	seed(seedValue);
+}
+
+/**
+ * Seeds the random streams in a deterministic way. Every ant of every 
+ * iteration draws from its own numbered stream of the seed, so the 
+ * queries that follow return the same paths under any number of threads.
+ *
+ * @param value The seed
+ */
+void AntSystem::seed(std::uint64_t value)
+{
+	seedValue = value;
+	streams = 0;
 }
 
 /**
@@ -94,306 +268,1932 @@ void AntSystem::init(int ants, int iterations)
  */
 std::vector<int> AntSystem::path(int start, int end)
 {
-	std::vector<int> bestPath;
-	double shortest = std::numeric_limits<double>::max();
-	// For the predefined number of iterations
+	return query(start, end).path;
+}
+
+/**
+ * Runs the Ant System from a source node to a destination until one of 
+ * the stopping criteria is met.
+ *
+ * @param start Path's starting point
+ * @param end Path's end point
+ * @param hint Supplier of a known path, e.g., an exact one, if any
+ * @return Result The best path, its length and why the colony stopped
+ */
+AntSystem::Result AntSystem::query(int start, int end, const Hint& hint)
+{
+	return colony(std::vector<int>(1, start), end, hint).front();
+}
+
+/**
+ * Finds the best paths of many source and destination pairs. The pairs 
+ * that share a destination are answered by one colony, whose ants start 
+ * from all the sources and share the pheromone trails.
+ *
+ * @param pairs The source and destination pairs
+ * @return std::vector<std::vector<int>> The best path of every pair
+ */
+std::vector<std::vector<int>> AntSystem::paths(
+		std::span<const std::pair<int, int>> pairs)
+{
+	// Group the distinct sources per destination, keeping their positions
+	std::map<int, std::vector<int>> sources;
+	std::map<std::pair<int, int>, std::vector<int>> positions;
+	for(unsigned int index = 0; index < pairs.size(); ++index)
+	{
+		std::vector<int>& position = positions[pairs[index]];
+		if(position.empty())
+			sources[pairs[index].second].push_back(pairs[index].first);
+		position.push_back(index);
+	}
+
+	std::vector<std::vector<int>> bestPaths(pairs.size());
+	for(auto& group : sources)
+	{
+		std::vector<Result> results = colony(group.second, group.first);
+		for(unsigned int s = 0; s < group.second.size(); ++s)
+			for(int index : positions[std::make_pair(group.second[s], group.first)])
+				bestPaths[index] = results[s].path;
+	}
+
+	return bestPaths;
+}
+
+/**
+ * Runs one colony towards a destination, with an equal number of ants 
+ * released from every source in each iteration, until one of the stopping 
+ * criteria is met.
+ *
+ * @param sources Paths' starting points
+ * @param end Paths' end point
+ * @param hint Supplier of known paths from the sources, if any
+ * @return std::vector<Result> The outcome for every source
+ */
+std::vector<AntSystem::Result> AntSystem::colony(const std::vector<int>& sources, 
+		int end, const Hint& hint)
+{
+	auto began = std::chrono::steady_clock::now();
+	int groups = static_cast<int>(sources.size());
+	std::vector<Result> results(groups);
+	std::vector<double> shortest(groups, std::numeric_limits<double>::max());
+	StopReason reason = StopReason::ITERATIONS;
+	// For the predefined number of iterations, or less when warm-started
+	int budget = iterations;
+	const Table* table = tableCapacity > 0 ? restoreTable(end) : nullptr;
+	if(table)
+	{
+		// The cached best tours still compete, under the current weights
+		budget = warmIterations;
+		for(int s = 0; s < groups; ++s)
+		{
+			auto it = table->bests.find(sources[s]);
+			if(it == table->bests.end())
+				continue;
+			results[s].path = it->second;
+			shortest[s] = results[s].length = calcTourLength(results[s].path);
+		}
+	}
+	if(hint)
+		layHints(sources, end, hint);
+	if(criteria.maxIterations > 0)
+		budget = std::min(budget, criteria.maxIterations);
 	
-	for(int i = 0; i < iterations; ++i)
+	guide(sources, end);
+	refreshAttractions();
+	referenceLength = 0;
+	int workers = static_cast<int>(walkers.size());
+	if(instrumented)
 	{
-		std::map<int, std::vector<int> > antTraces;
-		std::map<int, double> tourLengths;
-		// Release ants from source node and let them traverse the graph 
-		// structure to reach a destination
-		for(int j = 1; j <= ants; ++j)
+		++statistics.colonies;
+		statistics.trajectory.clear();
+		for(Walker& walker : walkers)
 		{
-			// This trace will be used by this ant to store its node sequence
-			std::vector<int> antTrace;
-			goAnt(start, end, antTrace);
-
-			if(antTrace.size() > 1 && antTrace.front() == start 
-					&& antTrace.back() == end)
+			walker.arrived = walker.cycles = walker.deadEnds = walker.pruned = 0;
+			walker.tourLengths = 0;
+			walker.lengthTime = std::chrono::nanoseconds(0);
+		}
+	}
+	int total = ants * groups;
+	std::vector<int> bests(workers * groups);
+	std::vector<double> limits(groups);
+	int stagnant = 0;
+	bool migrating = migration && migrationInterval > 0;
+	int i = 0;
+	while(i < budget)
+	{
+		auto constructStart = instrumented ? std::chrono::steady_clock::now() 
+				: std::chrono::steady_clock::time_point();
+		std::uint64_t stream = streams;
+		streams += total;
+		tours.reset(workers, total);
+		// Walks longer than the shortest tours so far by the pruning factor 
+		// are abandoned, while the tours found meanwhile are not taken into 
+		// account, so that the outcome is independent of the workers
+		for(int s = 0; s < groups; ++s)
+			limits[s] = strategy.pruning > 0 && shortest[s] < std::numeric_limits<double>::max() 
+					? shortest[s] * strategy.pruning : std::numeric_limits<double>::infinity();
+		if(strategy.bidirectional)
+		{
+			// Forward ants explore first, so that backward ones can meet them
+			buildReverse();
+			refreshReverse();
+			forwardAnts = (ants + 1) / 2;
+			explorations.reset(workers, total);
+			auto explore = [&](int worker)
 			{
-				// Destination reached, so calculate tour length and keep the shortest one
-				antTraces.insert(std::make_pair(j, antTrace));
-				tourLengths[j] = calcTourLength(antTrace);
-				if(tourLengths[j] > 0 && tourLengths[j] < shortest)
+				int last = static_cast<int>(static_cast<long int>(total) 
+						* (worker + 1) / workers);
+				int first = static_cast<int>(static_cast<long int>(total) 
+						* worker / workers);
+				std::vector<int>& buffer = explorations.buffers[worker].nodes;
+				for(int j = first; j < last; ++j)
 				{
-					shortest = tourLengths[j];
-					bestPath = antTrace;
+					int offset = (int)buffer.size();
+					if(j % ants < forwardAnts)
+					{
+						walkers[worker].gen.seed(seedValue, stream + j);
+						walkers[worker].limit = limits[j / ants];
+						walk<false>(sources[j / ants], end, buffer, walkers[worker], -1);
+					}
+					explorations.entries[j] = {worker, offset, (int)buffer.size() - offset, 0};
 				}
-			}
+			};
+			if(pool)
+				pool->run(explore);
 			else
+				explore(0);
+			markMeetings(groups);
+		}
+		// Release ants from source nodes and let them traverse the graph 
+		// structure to reach the destination. Each worker handles a fixed 
+		// share of the ants and keeps the best tour of every source.
+		auto construct = [&](int worker)
+		{
+			int* best = &bests[worker * groups];
+			std::fill(best, best + groups, -1);
+			int last = static_cast<int>(static_cast<long int>(total) 
+					* (worker + 1) / workers);
+			int first = static_cast<int>(static_cast<long int>(total) 
+					* worker / workers);
+			// The worker's buffer stores the node sequences of its ants
+			std::vector<int>& buffer = tours.buffers[worker].nodes;
+			for(int j = first; j < last; ++j)
 			{
-				// Well, this ant failed to reach its destination
-				antTraces.insert(std::make_pair(j, std::vector<int>()));
-				tourLengths[j] = 0;
+				int s = j / ants;
+				int start = sources[s];
+				int offset = (int)buffer.size();
+				walkers[worker].gen.seed(seedValue, stream + j);
+				walkers[worker].limit = limits[s];
+				if(strategy.bidirectional)
+					joinAnt(j, s, start, end, buffer, walkers[worker]);
+				else
+					goAnt(start, end, buffer, walkers[worker]);
+
+				Tours::Entry& entry = tours.entries[j];
+				entry = {worker, offset, (int)buffer.size() - offset, 0};
+				if(entry.size > 1 && buffer[offset] == start && buffer.back() == end)
+				{
+					// Destination reached, where the walk has summed the tour's 
+					// length unless it is joined from two walks
+					auto length = [&]()
+					{
+						return strategy.bidirectional ? calcTourLength(tours.trace(j)) 
+								: walkers[worker].length;
+					};
+					if(instrumented)
+					{
+						auto lengthStart = std::chrono::steady_clock::now();
+						entry.length = length();
+						walkers[worker].lengthTime += std::chrono::steady_clock::now() 
+								- lengthStart;
+						++walkers[worker].arrived;
+						walkers[worker].tourLengths += entry.length;
+					}
+					else
+						entry.length = length();
+					if(entry.length > 0 && (best[s] == -1 
+							|| entry.length < tours.entries[best[s]].length))
+						best[s] = j;
+				}
+				else
+				{
+					// Well, this ant failed to reach its destination
+					buffer.resize(offset);
+					entry.size = 0;
+				}
+			}
+		};
+		if(pool)
+			pool->run(construct);
+		else
+			construct(0);
+		auto updateStart = instrumented ? std::chrono::steady_clock::now() 
+				: std::chrono::steady_clock::time_point();
+		if(instrumented)
+			statistics.constructTime += updateStart - constructStart;
+
+		// Reduce the workers' results and keep the shortest tours
+		++stagnant;
+		for(int worker = 0; worker < workers; ++worker)
+			for(int s = 0; s < groups; ++s)
+			{
+				int best = bests[worker * groups + s];
+				if(best != -1 && tours.entries[best].length < shortest[s])
+				{
+					shortest[s] = results[s].length = tours.entries[best].length;
+					std::span<const int> trace = tours.trace(best);
+					results[s].path.assign(trace.begin(), trace.end());
+					stagnant = 0;
+				}
 			}
-		}
 
 		// Update pheromone trails upon the correct node sequences
-		updateTrails(antTraces, tourLengths);
+		updateTrails(tours, results);
+		++i;
+		if(migrating && i % migrationInterval == 0 
+				&& migrate(sources, end, results, shortest))
+			stagnant = 0;
+		refreshAttractions();
+		if(instrumented)
+		{
+			statistics.updateTime += std::chrono::steady_clock::now() - updateStart;
+			statistics.trajectory.push_back(*std::min_element(shortest.begin(), 
+					shortest.end()));
+		}
+
+		// Check the stopping criteria besides the iteration budget, except 
+		// while migrating, as every island must exchange as often as the others
+		if(migrating)
+			continue;
+		if(criteria.stagnation > 0 && stagnant >= criteria.stagnation)
+		{
+			reason = StopReason::STAGNATION;
+			break;
+		}
+		if(criteria.entropy > 0 && converged(results))
+		{
+			reason = StopReason::ENTROPY;
+			break;
+		}
+		if(criteria.deadline.count() > 0 
+				&& std::chrono::steady_clock::now() - began >= criteria.deadline)
+		{
+			reason = StopReason::DEADLINE;
+			break;
+		}
 	}
 
-	return bestPath;
+	guided = false;
+	if(instrumented)
+	{
+		statistics.iterations += i;
+		for(Walker& walker : walkers)
+		{
+			statistics.arrived += walker.arrived;
+			statistics.cycles += walker.cycles;
+			statistics.deadEnds += walker.deadEnds;
+			statistics.pruned += walker.pruned;
+			statistics.tourLengths += walker.tourLengths;
+			statistics.lengthTime += walker.lengthTime;
+		}
+	}
+	if(tableCapacity > 0)
+		storeTable(end, results);
+	checkpoint();
+
+	for(int s = 0; s < groups; ++s)
+	{
+		results[s].length = results[s].path.empty() ? 0 : shortest[s];
+		results[s].iterations = i;
+		results[s].reason = reason;
+	}
+	return results;
 }
 
 /**
- * Clears instance's state
+ * Lays a trail along the hinted path of every source as if all the ants of 
+ * an iteration had walked it, once per source after every change of the 
+ * topology or its weights, so that re-routing starts from a good path. The hints do 
+ * not compete as tours, so the ants still find the paths on their own.
+ *
+ * @param sources Paths' starting points
+ * @param end Paths' end point
+ * @param hint Supplier of known paths
  */
-void AntSystem::clear()
+void AntSystem::layHints(const std::vector<int>& sources, int end, const Hint& hint)
 {
-	edge2phero.clear();
-	edges.clear();
+	auto version = std::make_pair(layout, weightVersion);
+	auto& laid = hinted[end];
+	for(int start : sources)
+	{
+		auto it = laid.find(start);
+		if(it != laid.end() && it->second == version)
+			continue;
+		laid[start] = version;
+
+		std::vector<int> known = hint(start, end);
+		bool valid = known.size() > 1 && known.front() == start && known.back() == end;
+		for(unsigned int h = 0; valid && h + 1 < known.size(); ++h)
+			valid = findSlot(known[h], known[h + 1]) != -1;
+		double length = valid ? calcTourLength(known) : 0;
+		if(length > 0)
+			deposit(known, ants * diffPheromone(length), std::numeric_limits<Level>::max());
+	}
 }
 
 /**
- * Returns the amount of pheromone difference according to tour's length.
+ * Checks whether the entropy upon every best tour has dropped to the 
+ * threshold of the stopping criteria.
  *
- * @param length Tour's length produced by an ant
- * @return double Amount of pheromone
+ * @param results The outcome for every source so far
+ * @return bool The indication of convergence
  */
-double AntSystem::diffPheromone(double length)
+bool AntSystem::converged(const std::vector<Result>& results)
 {
-	return PHERO_QUANTITY / length;
+	for(auto& result : results)
+		if(result.path.size() <= 1 || entropy(result.path) > criteria.entropy)
+			return false;
+
+	return true;
 }
 
 /**
- * Updates pheromone levels upon all graph edges.
+ * Writes the current pheromone levels to a file. Edges are identified by 
+ * their end points, so the checkpoint remains valid for any instance 
+ * holding the same topology. The file is replaced atomically.
  *
- * @param antTraces Created traces by ants
- * @param tourLengths The length of traces
+ * @param filename The checkpoint file
  */
-void AntSystem::updateTrails(std::map<int, std::vector<int>>& antTraces,
-							 std::map<int, double>& tourLengths)
+void AntSystem::savePheromone(const std::string& filename) const
 {
-	// First, evaporate all existing pheromone levels
-	for(auto& pair : edge2phero)
-		pair.second *= (1 - EVAPO_RATE);
+	const Graph& g = *graph;
+	CheckpointHeader header = {};
+	std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+	header.version = CHECKPOINT_VERSION;
+	header.order = CHECKPOINT_ORDER;
+	// One record per live slot, as instances upon a shared topology keep 
+	// no edges of their own
+	for(int node = 0; node < (int)g.starts.size(); ++node)
+		header.records += g.degrees[node];
 
-	// Then, increase pheromone level upon correct paths
-	for(auto& pair : edge2phero)
+	std::string temporary = filename + ".tmp";
 	{
-		int edgeStart = pair.first.edgeStart;
-		int edgeEnd = pair.first.edgeEnd;
-		std::map<int, std::vector<int>>::iterator ait = antTraces.begin();
-		while(ait != antTraces.end())
-		{
-			// For every ant trace
-			std::vector<int> trace = (*ait).second;
-			if(trace.size() <= 1)
-			{	
-				ait++;
-				continue;
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		if(!file)
+			throw std::runtime_error(temporary + ": cannot open file");
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		for(int node = 0; node < (int)g.starts.size(); ++node)
+			for(int slot = g.starts[node]; slot < g.starts[node] + g.degrees[node]; ++slot)
+			{
+				CheckpointRecord record = {node, g.targets[slot], pheros[slot]};
+				file.write(reinterpret_cast<const char*>(&record), sizeof(record));
 			}
-			
-			// In case it's valid, add an amount of pheromone that depends on 
-			// each tour length
-			for(unsigned int i = 0; i < trace.size() - 1; ++i)
-				if(trace.at(i) == edgeStart && trace.at(i + 1) == edgeEnd)
-					edge2phero[pair.first] += diffPheromone(tourLengths[(*ait).first]);
-			ait++;
-		}
+		if(!file.flush())
+			throw std::runtime_error(temporary + ": cannot write checkpoint");
 	}
+
+	if(std::rename(temporary.c_str(), filename.c_str()))
+		throw std::runtime_error(filename + ": cannot replace checkpoint");
 }
 
 /**
- * Recursive method that finds a suitable trace from a starting 
- * point to a specific destination by unleashing an ant.
+ * Restores pheromone levels from a checkpoint. Edges missing from the 
+ * topology are skipped and edges missing from the checkpoint keep their 
+ * current level, while a file whose size differs from its number of 
+ * records is rejected.
  *
- * @param start Path's starting point
- * @param end Path's destination
- * @param trace Container where path's nodes will be stored
+ * @param filename The checkpoint file
+ * @return int Number of restored edges
  */
-void AntSystem::goAnt(int start, int end, std::vector<int>& trace)
+int AntSystem::restorePheromone(const std::string& filename)
 {
-	// Detect cycles and give up this attempt
-	if(isCyclic(start, trace))
+	MappedFile file(filename);
+	CheckpointHeader header;
+	if(file.size() < sizeof(header))
+		throw std::runtime_error(filename + ": not a checkpoint");
+	std::memcpy(&header, file.data(), sizeof(header));
+	if(std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) 
+			|| header.version != CHECKPOINT_VERSION || header.order != CHECKPOINT_ORDER)
+		throw std::runtime_error(filename + ": not a checkpoint");
+	if(header.records != (file.size() - sizeof(header)) / sizeof(CheckpointRecord) 
+			|| (file.size() - sizeof(header)) % sizeof(CheckpointRecord))
+		throw std::runtime_error(filename + ": checkpoint size does not match its records");
+
+	int restored = 0;
+	const char* pos = file.data() + sizeof(header);
+	for(std::uint64_t index = 0; index < header.records; ++index)
 	{
-		trace.clear();
-		return;
+		CheckpointRecord record;
+		std::memcpy(&record, pos + index * sizeof(record), sizeof(record));
+		int slot = findSlot(record.edgeStart, record.edgeEnd);
+		if(slot != -1)
+		{
+			pheros[slot] = static_cast<Level>(record.level);
+			++restored;
+		}
 	}
-	// Destination reached
-	if(start == end && trace.size() > 0)
-	{
-		trace.push_back(start);
+	// Without cached tables, the levels replaced held the hints of all the 
+	// destinations
+	if(tableCapacity == 0)
+		hinted.clear();
+
+	refreshAttractions();
+	return restored;
+}
+
+/**
+ * Enables writing the pheromone levels to a file after the queries that 
+ * complete once the interval has elapsed since the previous checkpoint.
+ *
+ * @param filename The checkpoint file, with an empty name disabling them
+ * @param interval The minimum time between checkpoints
+ */
+void AntSystem::setCheckpoint(const std::string& filename, 
+		std::chrono::milliseconds interval)
+{
+	checkpointFile = filename;
+	checkpointInterval = interval;
+	lastCheckpoint = std::chrono::steady_clock::now();
+}
+
+/**
+ * Writes a periodic checkpoint when it's due.
+ */
+void AntSystem::checkpoint()
+{
+	if(checkpointFile.empty())
 		return;
-	}
 
-	// Get available physical neighbours
-	std::vector<int> neighs = availNeighbours(start);
-	double probs[neighs.size()];
-	int index = 0;
-	// Produce a transition probability to each one
-	for(int neigh : neighs)
-		probs[index++] = prob(start, neigh);
+	auto now = std::chrono::steady_clock::now();
+	if(now - lastCheckpoint < checkpointInterval)
+		return;
 
-	std::uniform_real_distribution<> distro(0, 1);
-	double value = distro(gen);
-	// Sort probabilities in range [0, 1] and use a uniform dice to 
-	// pick up an index domain
-	index = 0; double sum = 0;
-	for(; index < (int)neighs.size(); ++index)
+	try
 	{
-		sum += probs[index];
-		if(value <= sum)
-			break;
+		savePheromone(checkpointFile);
+		lastCheckpoint = now;
 	}
-
-	// This index belongs to the chosen neighbour
-	int chosenNeighbour = (neighs.size() > 0) ? neighs[index] : -1;
-	if(chosenNeighbour == -1)
+	catch(std::exception& e)
 	{
-		// No available neighbour found, so give up
-		trace.clear();
-		return;
+		std::cerr << e.what() << std::endl;
 	}
-		
-	// Recurse to the next neighbour
-	trace.push_back(start);	
-	goAnt(chosenNeighbour, end, trace);
 }
 
 /**
- * Calculates path's length.
+ * Sets the criteria that stop a query before its iteration budget runs out.
  *
- * @param tour Container with path's nodes
- * @return double Tour's length
+ * @param criteria The stopping criteria, where zero values are disabled
  */
-double AntSystem::calcTourLength(std::vector<int>& tour)
+void AntSystem::setStopCriteria(const StopCriteria& criteria)
 {
-	if(tour.size() <= 1)
-		return 0;
-
-	double weightSum = 0;
-	for(unsigned int i = 0; i < tour.size() - 1; ++i)
-	{
-		// Find the edge that starts with current trace node
-		auto it = std::find_if(edge2phero.cbegin(), edge2phero.cend(),
-				[&tour, i](std::pair<Edge, double> pair)
-				{
-					return pair.first.edgeStart == tour[i] 
-							&& pair.first.edgeEnd == tour[i + 1];
-				});
-
-		if(it != edge2phero.cend())
-			weightSum += (*it).first.weight;
-	}
-
-	return weightSum;
+	this->criteria = criteria;
 }
 
 /**
- * Returns the probability of selecting the second node as destination, from 
- * the first one.
+ * Sets the rule and parameters of the pheromone update of later queries.
  *
- * @param edgeStart The edge's starting point
- * @param edgeEnd The edge's end point
- * @return double The probability
+ * @param strategy The update strategy
  */
-double AntSystem::prob(int edgeStart, int edgeEnd)
-{	
-	double numerator = std::pow(pheromone(edgeStart, edgeEnd), A_PAR) 
-			* std::pow(heuInfo(edgeStart, edgeEnd), B_PAR);
-
-	double denumerator = 0;
-	std::vector<int> neighs = availNeighbours(edgeStart);
-	for(int neigh : neighs)
-		denumerator += std::pow(pheromone(edgeStart, neigh), A_PAR) 
-				* std::pow(heuInfo(edgeStart, neigh), B_PAR);
-
-	return numerator / denumerator;
+void AntSystem::setStrategy(const Strategy& strategy)
+{
+	this->strategy = strategy;
 }
 
 /**
- * Returns the 'amount' of heuristic information from first input node to 
- * the second.
+ * Enables or disables collecting the statistics of later colonies. Only
+ * the timers cost anything noticeable, so they run while enabled only.
  *
- * @param edgeStart The edge's starting point
- * @param edgeEnd The edge's end point
- * @return double The amount of heuristic information
+ * @param enabled The indication of collecting statistics
  */
-double AntSystem::heuInfo(int edgeStart, int edgeEnd)
+void AntSystem::setInstrumentation(bool enabled)
 {
-	// Find the edge with this lambda function and use its weight
-	auto it = std::find_if(edge2phero.cbegin(), edge2phero.cend(),
-			[edgeStart, edgeEnd](std::pair<Edge, double> pair)
-			{
-				return pair.first.edgeStart == edgeStart
-						&& pair.first.edgeEnd == edgeEnd;
-			});
+	instrumented = enabled;
+}
 
-	return it != edge2phero.cend() ? 1 / (*it).first.weight : 0;
+/**
+ * Lets the colonies of an island model exchange their best tours every 
+ * few iterations. The tours received compete with the best ones of this 
+ * colony and deposit once like the tour of an ant. Exchanges block until 
+ * the other colonies exchange as well, so the stagnation, entropy and 
+ * deadline criteria are ignored meanwhile and all colonies must run the 
+ * same queries with the same iteration budget and warm-start settings.
+ *
+ * @param migration The exchange with the other colonies, none disabling it
+ * @param interval Iterations between exchanges
+ */
+void AntSystem::setMigration(const Migration& migration, int interval)
+{
+	this->migration = migration;
+	migrationInterval = interval;
 }
 
 /**
- * Returns the amount of pheromone from first input node to the second.
+ * Returns the statistics collected since the last reset.
  *
- * @param edgeStart The edge's starting point
- * @param edgeEnd The edge's end point
- * @return double The amount of pheromone
+ * @return const Stats& The statistics
  */
-double AntSystem::pheromone(int edgeStart, int edgeEnd)
+const AntSystem::Stats& AntSystem::stats() const
 {
-	// Find the edge with this lambda function and return its pheromone level
-	auto it = std::find_if(edge2phero.cbegin(), edge2phero.cend(),
-			[edgeStart, edgeEnd](std::pair<Edge, double> pair)
-			{
-				return pair.first.edgeStart == edgeStart
-						&& pair.first.edgeEnd == edgeEnd;
-			});
+	return statistics;
+}
 
-	return it != edge2phero.cend() ? (*it).second : 0;
+/**
+ * Clears the collected statistics.
+ */
+void AntSystem::resetStats()
+{
+	statistics = Stats();
 }
 
 /**
- * Finds all available neighbours of input node.
+ * Sends the best tours of every source to the other colonies and takes 
+ * the valid tours received towards the same destination.
  *
- * @param node The input node
- * @return std::vector<int> Container with nodes
+ * @param sources Paths' starting points
+ * @param end Paths' end point
+ * @param results The best tour of every source, replaced by shorter ones
+ * @param shortest The length of every best tour
+ * @return bool The indication of a shorter tour being received
  */
-std::vector<int> AntSystem::availNeighbours(int node)
+bool AntSystem::migrate(const std::vector<int>& sources, int end, 
+		std::vector<Result>& results, std::vector<double>& shortest)
 {
-	std::vector<int> neighbours;
-	
-	// Find all edges that start from the input node and return its 
-	// other endpoints
-	std::for_each(edge2phero.cbegin(), edge2phero.cend(),
-			[&neighbours, node](std::pair<Edge, double> pair)
+	std::vector<std::vector<int>> outgoing;
+	for(auto& result : results)
+		if(!result.path.empty())
+			outgoing.push_back(result.path);
+	std::vector<std::vector<int>> incoming = migration(outgoing);
+
+	bool improved = false;
+	const Graph& g = *graph;
+	std::vector<char> visited(g.starts.size());
+	for(auto& tour : incoming)
+	{
+		if(tour.size() <= 1 || tour.back() != end)
+			continue;
+		auto source = std::find(sources.begin(), sources.end(), tour.front());
+		if(source == sources.end())
+			continue;
+
+		// Every hop must be an edge of this topology and no node repeats
+		double length = 0;
+		bool valid = true;
+		std::fill(visited.begin(), visited.end(), 0);
+		for(unsigned int i = 0; valid && i < tour.size(); ++i)
+		{
+			valid = tour[i] >= 0 && tour[i] < (int)visited.size() && !visited[tour[i]];
+			if(valid && i > 0)
 			{
-				if(pair.first.edgeStart == node)
-					neighbours.push_back(pair.first.edgeEnd);
-			});
+				int slot = findSlot(tour[i - 1], tour[i]);
+				valid = slot != -1;
+				if(valid)
+					length += g.weights[slot];
+			}
+			if(valid)
+				visited[tour[i]] = 1;
+		}
+		if(!valid || length <= 0)
+			continue;
+
+		if(strategy.rule != Rule::COLONY_SYSTEM)
+			deposit(tour, diffPheromone(length), std::numeric_limits<Level>::max());
+		int s = static_cast<int>(source - sources.begin());
+		if(length < shortest[s])
+		{
+			shortest[s] = results[s].length = length;
+			results[s].path = tour;
+			improved = true;
+		}
+	}
 
-	return neighbours;
+	return improved;
 }
 
 /**
- * Detects if a cycle is formed inside the sequence of nodes.
+ * Starts a new walk, so that no node counts as visited.
  *
- * @param nodes The sequence of nodes
- * @return bool The indication of a cyclic sequence
+ * @param nodes Number of nodes
  */
-bool AntSystem::isCyclic(int nd, const std::vector<int>& nodes)
+void AntSystem::Walker::begin(int nodes)
 {
-	std::set<int> uniqueNodes;
-	uniqueNodes.insert(nd);
-	for(int node : nodes)
-		uniqueNodes.insert(node);
-	
-	return nodes.size() + 1 != uniqueNodes.size();
+	if((int)stamps.size() != nodes)
+	{
+		stamps.assign(nodes, 0);
+		epoch = 0;
+	}
+	// A new epoch invalidates the visited marks of the previous walk
+	if(++epoch == 0)
+	{
+		std::fill(stamps.begin(), stamps.end(), 0);
+		epoch = 1;
+	}
 }
 
 /**
- * Inserts an edge.
- * 
- * @param src Source node
- * @param dest Destination node
- * @param weight Weight for the edge
+ * Prepares the tours for an iteration, keeping the memory of the previous 
+ * ones.
+ *
+ * @param workers Number of workers
+ * @param ants Number of ants
  */
-void AntSystem::insertEdge(int src, int dest, double weight)
+void AntSystem::Tours::reset(int workers, int ants)
 {
-	AdaptiveSystem::insertEdge(src, dest, weight);
-	edge2phero.clear();
-	for(auto& edge : edges)
-		edge2phero.insert({edge, static_cast<double>(PHERO_QUANTITY)});
+	buffers.resize(workers);
+	for(auto& buffer : buffers)
+		buffer.nodes.clear();
+	entries.resize(ants);
+}
+
+/**
+ * Returns the node sequence of an ant's tour.
+ *
+ * @param ant The ant's number
+ * @return std::span<const int> The nodes, none when the ant failed
+ */
+std::span<const int> AntSystem::Tours::trace(int ant) const
+{
+	const Entry& entry = entries[ant];
+	return std::span<const int>(buffers[entry.worker].nodes.data() + entry.offset, entry.size);
+}
+
+/**
+ * Returns the average length of the tours that reached their destination.
+ *
+ * @return double The average length or 0 without any such tour
+ */
+double AntSystem::Stats::averageLength() const
+{
+	return arrived > 0 ? tourLengths / arrived : 0;
+}
+
+/**
+ * Formats the statistics as a JSON object, with null for the iterations
+ * of the trajectory before any tour was found.
+ *
+ * @return std::string The JSON object
+ */
+std::string AntSystem::Stats::json() const
+{
+	std::ostringstream out;
+	out.precision(17);
+	out << "{\"colonies\":" << colonies << ",\"iterations\":" << iterations
+			<< ",\"ants\":{\"arrived\":" << arrived << ",\"cycles\":" << cycles
+			<< ",\"deadEnds\":" << deadEnds << ",\"pruned\":" << pruned << "},\"averageLength\":" << averageLength()
+			<< ",\"seconds\":{\"construct\":"
+			<< std::chrono::duration<double>(constructTime).count()
+			<< ",\"length\":" << std::chrono::duration<double>(lengthTime).count()
+			<< ",\"update\":" << std::chrono::duration<double>(updateTime).count()
+			<< "},\"trajectory\":[";
+	for(unsigned int i = 0; i < trajectory.size(); ++i)
+	{
+		if(i > 0)
+			out << ",";
+		if(trajectory[i] < std::numeric_limits<double>::max())
+			out << trajectory[i];
+		else
+			out << "null";
+	}
+	out << "]}";
+
+	return out.str();
+}
+
+/**
+ * Formats the statistics in the Prometheus text exposition format.
+ *
+ * @return std::string The metrics
+ */
+std::string AntSystem::Stats::prometheus() const
+{
+	std::ostringstream out;
+	out.precision(17);
+	out << "# TYPE acopath_colonies_total counter\n"
+			<< "acopath_colonies_total " << colonies << "\n"
+			<< "# TYPE acopath_iterations_total counter\n"
+			<< "acopath_iterations_total " << iterations << "\n"
+			<< "# TYPE acopath_ants_total counter\n"
+			<< "acopath_ants_total{outcome=\"arrived\"} " << arrived << "\n"
+			<< "acopath_ants_total{outcome=\"cycle\"} " << cycles << "\n"
+			<< "acopath_ants_total{outcome=\"dead_end\"} " << deadEnds << "\n"
+			<< "acopath_ants_total{outcome=\"pruned\"} " << pruned << "\n"
+			<< "# TYPE acopath_phase_seconds_total counter\n"
+			<< "acopath_phase_seconds_total{phase=\"construct\"} "
+			<< std::chrono::duration<double>(constructTime).count() << "\n"
+			<< "acopath_phase_seconds_total{phase=\"length\"} "
+			<< std::chrono::duration<double>(lengthTime).count() << "\n"
+			<< "acopath_phase_seconds_total{phase=\"update\"} "
+			<< std::chrono::duration<double>(updateTime).count() << "\n"
+			<< "# TYPE acopath_tour_length_average gauge\n"
+			<< "acopath_tour_length_average " << averageLength() << "\n";
+	if(!trajectory.empty() && trajectory.back() < std::numeric_limits<double>::max())
+		out << "# TYPE acopath_best_length gauge\n"
+				<< "acopath_best_length " << trajectory.back() << "\n";
+
+	return out.str();
+}
+
+/**
+ * Measures how much the colony has converged along a path, as the mean 
+ * entropy of the transition probabilities at its nodes. Each row's entropy 
+ * is normalised by its maximum, so the result lies in range [0, 1] and 
+ * becomes zero when every choice is certain.
+ *
+ * @param nodes The node sequence
+ * @return double The normalised entropy
+ */
+double AntSystem::entropy(const std::vector<int>& nodes)
+{
+	const Graph& g = *graph;
+	double total = 0;
+	int rows = 0;
+	for(unsigned int i = 0; i + 1 < nodes.size(); ++i)
+	{
+		int node = nodes[i];
+		int degree = g.degrees[node];
+		if(degree <= 1 || rowSums[node] <= 0)
+			continue;
+
+		double sum = 0;
+		for(int slot = g.starts[node]; slot < g.starts[node] + degree; ++slot)
+		{
+			double p = attracts[slot] / rowSums[node];
+			if(p > 0)
+				sum -= p * std::log(p);
+		}
+		total += sum / std::log(static_cast<double>(degree));
+		++rows;
+	}
+
+	return rows > 0 ? total / rows : 0;
+}
+
+/**
+ * Loads the cached pheromone table of a destination, or resets the 
+ * pheromone levels when there is no valid one.
+ *
+ * @param end The destination
+ * @return const Table* The loaded table or nullptr
+ */
+const AntSystem::Table* AntSystem::restoreTable(int end)
+{
+	auto it = tables.find(end);
+	if(it != tables.end() && it->second.layout == layout)
+	{
+		// Mark as the most recently used
+		recency.splice(recency.begin(), recency, it->second.position);
+		pheros = it->second.pheros;
+		return &it->second;
+	}
+
+	std::fill(pheros.begin(), pheros.end(), static_cast<Level>(PHERO_QUANTITY));
+	hinted.erase(end);
+	return nullptr;
+}
+
+/**
+ * Keeps the current pheromone levels as the table of a destination, along 
+ * with the best tours found towards it.
+ *
+ * @param end The destination
+ * @param results The outcome for every source
+ */
+void AntSystem::storeTable(int end, const std::vector<Result>& results)
+{
+	auto it = tables.find(end);
+	if(it == tables.end() || it->second.layout != layout)
+	{
+		if(it == tables.end())
+		{
+			if((int)tables.size() >= tableCapacity)
+				evictTable();
+			recency.push_front(end);
+			it = tables.emplace(end, Table()).first;
+			it->second.position = recency.begin();
+		}
+		it->second.bests.clear();
+	}
+	recency.splice(recency.begin(), recency, it->second.position);
+
+	it->second.pheros = pheros;
+	it->second.layout = layout;
+	for(auto& result : results)
+		if(result.path.size() > 1)
+			it->second.bests[result.path.front()] = result.path;
+}
+
+/**
+ * Evicts the least recently used pheromone table.
+ */
+void AntSystem::evictTable()
+{
+	if(recency.empty())
+		return;
+
+	tables.erase(recency.back());
+	hinted.erase(recency.back());
+	recency.pop_back();
+}
+
+/**
+ * Clears instance's state
+ */
+void AntSystem::clear()
+{
+	graph = std::make_shared<Graph>();
+	pheros.clear();
+	attracts.clear();
+	rowSums.clear();
+	aliasProbs.clear();
+	aliasIndices.clear();
+	edges.clear();
+	tables.clear();
+	recency.clear();
+	hinted.clear();
+	++layout;
+}
+
+/**
+ * Returns the amount of pheromone difference according to tour's length.
+ *
+ * @param length Tour's length produced by an ant
+ * @return double Amount of pheromone
+ */
+double AntSystem::diffPheromone(double length)
+{
+	return PHERO_QUANTITY / length;
+}
+
+/**
+ * Updates pheromone levels upon all graph edges according to the rule of 
+ * the update strategy.
+ *
+ * @param tours Created tours by ants, along with their lengths
+ * @param results The best tours so far
+ */
+void AntSystem::updateTrails(const Tours& tours, const std::vector<Result>& results)
+{
+	double rho = strategy.evaporation;
+	if(strategy.rule == Rule::COLONY_SYSTEM)
+	{
+		// The local updates of the ants' steps pull the levels towards the 
+		// initial one, and only the best tours so far evaporate and deposit. 
+		// Deposits are relative to the first tour found, so that the best 
+		// edges climb above the initial level once shorter tours appear.
+		const double initial = PHERO_QUANTITY;
+		double xi = strategy.localDecay;
+		for(int ant = 0; ant < (int)tours.entries.size(); ++ant)
+		{
+			std::span<const int> trace = tours.trace(ant);
+			for(unsigned int i = 0; i + 1 < trace.size(); ++i)
+			{
+				int slot = findSlot(trace[i], trace[i + 1]);
+				if(slot != -1)
+					pheros[slot] = static_cast<Level>((1 - xi) * pheros[slot] + xi * initial);
+			}
+		}
+		for(auto& result : results)
+		{
+			if(result.path.size() <= 1)
+				continue;
+			if(referenceLength <= 0)
+				referenceLength = result.length;
+			double diff = diffPheromone(result.length) * referenceLength;
+			for(unsigned int i = 0; i + 1 < result.path.size(); ++i)
+			{
+				int slot = findSlot(result.path[i], result.path[i + 1]);
+				if(slot != -1)
+					pheros[slot] = static_cast<Level>((1 - rho) * pheros[slot] + rho * diff);
+			}
+		}
+		return;
+	}
+
+	// First, evaporate all existing pheromone levels, stopping at the 
+	// smallest normal level so that no edge decays into denormals. The 
+	// Max-Min Ant System keeps them inside its bounds instead, with the 
+	// upper one being the level of the best tour so far in equilibrium.
+	Level floor = std::numeric_limits<Level>::min();
+	Level ceiling = std::numeric_limits<Level>::max();
+	if(strategy.rule == Rule::MAX_MIN)
+	{
+		double best = std::numeric_limits<double>::max();
+		for(auto& result : results)
+			if(!result.path.empty())
+				best = std::min(best, result.length);
+		if(best < std::numeric_limits<double>::max())
+		{
+			ceiling = static_cast<Level>(diffPheromone(best) / rho);
+			floor = std::max(floor, static_cast<Level>(ceiling * strategy.minRatio));
+		}
+	}
+	for(Level& phero : pheros)
+		phero = std::clamp(phero * static_cast<Level>(1 - rho), floor, ceiling);
+
+	if(strategy.rule == Rule::MAX_MIN)
+	{
+		// Only the tour of the iteration's best ant or the best tours so 
+		// far deposit
+		if(strategy.globalBest)
+		{
+			for(auto& result : results)
+				if(result.path.size() > 1)
+					deposit(result.path, diffPheromone(result.length), ceiling);
+		}
+		else
+		{
+			int best = -1;
+			for(int ant = 0; ant < (int)tours.entries.size(); ++ant)
+				if(tours.entries[ant].size > 1 && (best == -1 
+						|| tours.entries[ant].length < tours.entries[best].length))
+					best = ant;
+			if(best != -1)
+				deposit(tours.trace(best), diffPheromone(tours.entries[best].length), 
+						ceiling);
+		}
+		return;
+	}
+
+	// Then, walk every valid trace once and increase the pheromone level 
+	// of each edge it used by an amount that depends on its tour length
+	for(int ant = 0; ant < (int)tours.entries.size(); ++ant)
+		if(tours.entries[ant].size > 1)
+			deposit(tours.trace(ant), diffPheromone(tours.entries[ant].length), ceiling);
+
+	// Elitist ants reinforce the best tours so far once more
+	if(strategy.rule == Rule::ELITIST)
+		for(auto& result : results)
+			if(result.path.size() > 1)
+				deposit(result.path, strategy.elitism * diffPheromone(result.length), 
+						ceiling);
+}
+
+/**
+ * Increases the pheromone level of every edge of a tour.
+ *
+ * @param tour The tour's nodes
+ * @param amount The amount of pheromone
+ * @param ceiling The maximum level
+ */
+void AntSystem::deposit(std::span<const int> tour, double amount, Level ceiling)
+{
+	for(unsigned int i = 0; i + 1 < tour.size(); ++i)
+	{
+		int slot = findSlot(tour[i], tour[i + 1]);
+		if(slot != -1)
+			pheros[slot] = std::min(ceiling, static_cast<Level>(pheros[slot] + amount));
+	}
+}
+
+/**
+ * Iterative method that finds a suitable trace from a starting 
+ * point to a specific destination by unleashing an ant.
+ *
+ * @param start Path's starting point
+ * @param end Path's destination
+ * @param trace Container where path's nodes will be appended, left as it 
+ * was when the ant gives up
+ * @param walker The scratch state and random stream of the calling worker
+ */
+void AntSystem::goAnt(int start, int end, std::vector<int>& trace, Walker& walker)
+{
+	size_t base = trace.size();
+	if(!walk<false>(start, end, trace, walker, -1))
+		trace.resize(base);
+}
+
+/**
+ * Lets an ant walk from a node until it reaches the destination, a cycle 
+ * or a dead end. Backward ants walk the reversed edges and also stop at 
+ * the first node that a forward ant of their group has visited.
+ *
+ * @param start The walk's starting point
+ * @param end The walk's destination
+ * @param trace Container where the visited nodes will be appended, kept 
+ * even when the ant gives up
+ * @param walker The scratch state and random stream of the calling worker
+ * @param group The source group of a backward ant
+ * @return bool The indication of reaching the destination or a meeting node
+ */
+template<bool BACKWARD>
+bool AntSystem::walk(int start, int end, std::vector<int>& trace, Walker& walker, 
+		int group)
+{
+	const Graph& g = *graph;
+	int nodes = (int)g.starts.size();
+	walker.begin(nodes);
+
+	size_t base = trace.size();
+	walker.length = 0;
+	for(int node = start;;)
+	{
+		// Nodes without a row of their own are dead ends
+		if(node < 0 || node >= nodes)
+		{
+			++walker.deadEnds;
+			return false;
+		}
+		// Detect cycles and give up this attempt
+		if(walker.stamps[node] == walker.epoch)
+		{
+			++walker.cycles;
+			return false;
+		}
+		trace.push_back(node);
+		// Give up as soon as the walk cannot beat the shortest tour, without 
+		// the node that exceeded it, so that an ant pruned upon reaching the 
+		// destination does not pass for a tour
+		if(!BACKWARD && walker.length + (guided ? remaining[node] : 0) > walker.limit)
+		{
+			trace.pop_back();
+			++walker.pruned;
+			return false;
+		}
+		// Destination reached
+		if(node == end && trace.size() > base + 1)
+			return true;
+		if constexpr(BACKWARD)
+			if(node != start && meetings[group * nodes + node].stamp == meetEpoch)
+				return true;
+
+		// Get available physical neighbours
+		int first, degree;
+		const Level* rowAttracts;
+		double rowSum;
+		if constexpr(BACKWARD)
+		{
+			first = reverseStarts[node];
+			degree = reverseStarts[node + 1] - first;
+			rowAttracts = &reverseAttracts[first];
+			rowSum = reverseSums[node];
+		}
+		else
+		{
+			first = g.starts[node];
+			degree = g.degrees[node];
+			rowAttracts = &attracts[first];
+			rowSum = rowSums[node];
+		}
+		if(degree == 0 || rowSum <= 0)
+		{
+			// No available neighbour found, so give up
+			++walker.deadEnds;
+			return false;
+		}
+
+		// Use a uniform dice to pick up an index domain, either from the 
+		// alias table of a hub node or scaled by the row's total attraction. 
+		// The pseudo-random-proportional rule of Ant Colony System exploits 
+		// the most attractive edge instead with a fixed probability.
+		int index;
+		if(strategy.rule == Rule::COLONY_SYSTEM 
+				&& walker.gen.uniform() < strategy.exploitation)
+			index = static_cast<int>(std::max_element(rowAttracts, 
+					rowAttracts + degree) - rowAttracts);
+		else if(!BACKWARD && degree >= ALIAS_DEGREE)
+			index = Roulette::spinAlias(&aliasProbs[first], &aliasIndices[first], 
+					degree, walker.gen.uniform());
+		else
+			index = Roulette::spin(rowAttracts, degree, 
+					static_cast<Level>(walker.gen.uniform() * rowSum));
+
+		// Move on to the chosen neighbour
+		walker.stamps[node] = walker.epoch;
+		walker.length += g.weights[BACKWARD ? reverseSlots[first + index] : first + index];
+		node = BACKWARD ? reverseSources[first + index] : g.targets[first + index];
+	}
+}
+
+/**
+ * Builds the tour of an ant in bidirectional mode. Forward ants keep the 
+ * walks of the exploration that reached the destination. Backward ants 
+ * walk from the destination until they meet the walk of a forward ant, 
+ * which is joined with their own after erasing any loop. Joined tours 
+ * longer than the walker's limit are given up, while the backward walks 
+ * themselves are not pruned, as erasing loops may shorten them.
+ *
+ * @param ant The ant's number
+ * @param group The ant's source group
+ * @param start Path's starting point
+ * @param end Path's destination
+ * @param trace Container where the tour's nodes will be appended
+ * @param walker The scratch state and random stream of the calling worker
+ */
+void AntSystem::joinAnt(int ant, int group, int start, int end, 
+		std::vector<int>& trace, Walker& walker)
+{
+	if(ant % ants < forwardAnts)
+	{
+		std::span<const int> explored = explorations.trace(ant);
+		if(explored.size() > 1 && explored.back() == end)
+			trace.insert(trace.end(), explored.begin(), explored.end());
+		return;
+	}
+
+	std::vector<int>& backward = walker.backward;
+	backward.clear();
+	if(!walk<true>(end, start, backward, walker, group))
+		return;
+
+	// The forward part up to the meeting node, then the backward one reversed
+	std::vector<int>& joined = walker.joined;
+	joined.clear();
+	int meet = backward.back();
+	if(meet != start)
+	{
+		const Meeting& meeting = meetings[group * (int)graph->starts.size() + meet];
+		std::span<const int> explored = explorations.trace(meeting.ant);
+		joined.insert(joined.end(), explored.begin(), explored.begin() + meeting.position);
+	}
+	joined.insert(joined.end(), backward.rbegin(), backward.rend());
+
+	// Erase loops, so that every node is visited once
+	walker.begin((int)graph->starts.size());
+	size_t base = trace.size();
+	for(int node : joined)
+	{
+		if(walker.stamps[node] == walker.epoch)
+			while(trace.back() != node)
+			{
+				walker.stamps[trace.back()] = 0;
+				trace.pop_back();
+			}
+		else
+		{
+			walker.stamps[node] = walker.epoch;
+			trace.push_back(node);
+		}
+	}
+	if(trace.size() - base < 2)
+		trace.resize(base);
+	else if(walker.limit < std::numeric_limits<double>::infinity() 
+			&& calcTourLength(std::span<const int>(trace).subspan(base)) > walker.limit)
+	{
+		++walker.pruned;
+		trace.resize(base);
+	}
+}
+
+/**
+ * Marks every node visited by the forward ants of the exploration with 
+ * the shortest walk that reached it, per source group.
+ *
+ * @param groups Number of source groups
+ */
+void AntSystem::markMeetings(int groups)
+{
+	const Graph& g = *graph;
+	int nodes = (int)g.starts.size();
+	if((int)meetings.size() != groups * nodes)
+	{
+		meetings.assign(groups * nodes, Meeting());
+		meetEpoch = 0;
+	}
+	if(++meetEpoch == 0)
+	{
+		std::fill(meetings.begin(), meetings.end(), Meeting());
+		meetEpoch = 1;
+	}
+
+	for(int s = 0; s < groups; ++s)
+		for(int ant = s * ants; ant < s * ants + forwardAnts; ++ant)
+		{
+			std::span<const int> explored = explorations.trace(ant);
+			double length = 0;
+			for(int position = 0; position < (int)explored.size(); ++position)
+			{
+				if(position > 0)
+					length += g.weights[findSlot(explored[position - 1], 
+							explored[position])];
+				Meeting& meeting = meetings[s * nodes + explored[position]];
+				if(meeting.stamp != meetEpoch || length < meeting.length)
+					meeting = {meetEpoch, ant, position, length};
+			}
+		}
+}
+
+/**
+ * Builds the reversed adjacency, where the row of a node lists the edges 
+ * that end at it, unless the layout is unchanged since the last time.
+ */
+void AntSystem::buildReverse()
+{
+	if(reverseLayout == layout)
+		return;
+
+	const Graph& g = *graph;
+	int nodes = (int)g.starts.size();
+	reverseStarts.assign(nodes + 1, 0);
+	for(int node = 0; node < nodes; ++node)
+		for(int slot = g.starts[node]; slot < g.starts[node] + g.degrees[node]; ++slot)
+			++reverseStarts[g.targets[slot] + 1];
+	for(int node = 0; node < nodes; ++node)
+		reverseStarts[node + 1] += reverseStarts[node];
+
+	std::vector<int> next(reverseStarts.begin(), reverseStarts.end() - 1);
+	reverseSources.resize(reverseStarts[nodes]);
+	reverseSlots.resize(reverseStarts[nodes]);
+	for(int node = 0; node < nodes; ++node)
+		for(int slot = g.starts[node]; slot < g.starts[node] + g.degrees[node]; ++slot)
+		{
+			int pos = next[g.targets[slot]]++;
+			reverseSources[pos] = node;
+			reverseSlots[pos] = slot;
+		}
+	reverseAttracts.resize(reverseStarts[nodes]);
+	reverseSums.resize(nodes);
+	reverseLayout = layout;
+}
+
+/**
+ * Copies the current attractions into the reversed adjacency.
+ */
+void AntSystem::refreshReverse()
+{
+	for(int node = 0; node + 1 < (int)reverseStarts.size(); ++node)
+	{
+		double sum = 0;
+		for(int pos = reverseStarts[node]; pos < reverseStarts[node + 1]; ++pos)
+			sum += reverseAttracts[pos] = attracts[reverseSlots[pos]];
+		reverseSums[node] = sum;
+	}
+}
+
+/**
+ * Prepares the heuristic information of a colony. With landmarks, the 
+ * heuristic of an edge is the inverse of its weight plus the lower bound 
+ * of the distance from its end to the destination, scaled by the bound of 
+ * the first source, so that ants are drawn towards the destination and 
+ * never enter nodes that cannot reach it.
+ *
+ * @param sources Paths' starting points
+ * @param end Paths' end point
+ */
+void AntSystem::guide(const std::vector<int>& sources, int end)
+{
+	const Graph& g = *graph;
+	int nodes = (int)g.starts.size();
+	guided = strategy.landmarks > 0 && end >= 0 && end < nodes;
+	if(!guided)
+		return;
+	if(landmarkLayout != layout 
+			|| (int)fromLandmarks.size() != std::min(strategy.landmarks, nodes) * nodes)
+		buildLandmarks(strategy.landmarks);
+
+	double scale = sources.empty() ? 0 : bound(sources.front(), end);
+	if(!(scale > 0) || scale == std::numeric_limits<double>::infinity())
+		scale = 1;
+	remaining.resize(nodes);
+	for(int node = 0; node < nodes; ++node)
+		remaining[node] = bound(node, end);
+	guidance.resize(g.targets.size());
+	for(int node = 0; node < nodes; ++node)
+		for(int slot = g.starts[node]; slot < g.starts[node] + g.degrees[node]; ++slot)
+		{
+			double left = remaining[g.targets[slot]];
+			guidance[slot] = left == std::numeric_limits<double>::infinity() ? 0 
+					: scale / (g.weights[slot] + left);
+		}
+}
+
+/**
+ * Chooses landmarks one after another as the node farthest from the ones 
+ * chosen so far, preferring the nodes that none of them reaches, and finds 
+ * the distances from and to each of them.
+ *
+ * @param count Number of landmarks
+ */
+void AntSystem::buildLandmarks(int count)
+{
+	const Graph& g = *graph;
+	int nodes = (int)g.starts.size();
+	count = std::min(count, nodes);
+	buildReverse();
+	const double infinity = std::numeric_limits<double>::infinity();
+	fromLandmarks.assign((size_t)count * nodes, infinity);
+	toLandmarks.assign((size_t)count * nodes, infinity);
+
+	// Nodes without any edge are never chosen
+	std::vector<double> nearest(nodes, infinity);
+	for(int node = 0; node < nodes; ++node)
+		if(g.degrees[node] == 0 && reverseStarts[node] == reverseStarts[node + 1])
+			nearest[node] = -1;
+	int landmark = (int)(std::max_element(nearest.begin(), nearest.end()) 
+			- nearest.begin());
+	for(int k = 0; k < count && nearest[landmark] > 0; ++k)
+	{
+		distances(landmark, false, &fromLandmarks[(size_t)k * nodes]);
+		distances(landmark, true, &toLandmarks[(size_t)k * nodes]);
+		for(int node = 0; node < nodes; ++node)
+			if(nearest[node] >= 0)
+				nearest[node] = std::min(nearest[node], 
+						fromLandmarks[(size_t)k * nodes + node]);
+		landmark = (int)(std::max_element(nearest.begin(), nearest.end()) 
+				- nearest.begin());
+	}
+	landmarkLayout = layout;
+}
+
+/**
+ * Finds the shortest distances from a node or, upon the reversed edges, 
+ * to it.
+ *
+ * @param node The node
+ * @param reverse The indication of finding the distances to the node
+ * @param dists Distance of every node, infinite for the unreachable ones
+ */
+void AntSystem::distances(int node, bool reverse, double* dists)
+{
+	const Graph& g = *graph;
+	typedef std::pair<double, int> Entry;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+	dists[node] = 0;
+	queue.emplace(0, node);
+	while(!queue.empty())
+	{
+		auto [dist, current] = queue.top();
+		queue.pop();
+		if(dist > dists[current])
+			continue;
+
+		int first = reverse ? reverseStarts[current] : g.starts[current];
+		int last = reverse ? reverseStarts[current + 1] : first + g.degrees[current];
+		for(int pos = first; pos < last; ++pos)
+		{
+			int slot = reverse ? reverseSlots[pos] : pos;
+			int next = reverse ? reverseSources[pos] : g.targets[slot];
+			if(dist + g.weights[slot] < dists[next])
+			{
+				dists[next] = dist + g.weights[slot];
+				queue.emplace(dists[next], next);
+			}
+		}
+	}
+}
+
+/**
+ * Returns a lower bound of the distance between two nodes by the triangle 
+ * inequality upon every landmark.
+ *
+ * @param from The starting node
+ * @param to The ending node
+ * @return double The bound, infinite when the ending node is unreachable
+ */
+double AntSystem::bound(int from, int to) const
+{
+	const double infinity = std::numeric_limits<double>::infinity();
+	size_t nodes = graph->starts.size();
+	double best = 0;
+	for(size_t k = 0; k < fromLandmarks.size() / nodes; ++k)
+	{
+		const double* fromLandmark = &fromLandmarks[k * nodes];
+		const double* toLandmark = &toLandmarks[k * nodes];
+		if(fromLandmark[from] < infinity)
+			best = std::max(best, fromLandmark[to] - fromLandmark[from]);
+		if(toLandmark[to] < infinity)
+			best = std::max(best, toLandmark[from] - toLandmark[to]);
+	}
+
+	return best;
+}
+
+/**
+ * Calculates path's length.
+ *
+ * @param tour Container with path's nodes
+ * @return double Tour's length
+ */
+double AntSystem::calcTourLength(std::span<const int> tour)
+{
+	const Graph& g = *graph;
+	if(tour.size() <= 1)
+		return 0;
+
+	double weightSum = 0;
+	for(unsigned int i = 0; i < tour.size() - 1; ++i)
+	{
+		// Find the edge that starts with current trace node
+		int slot = findSlot(tour[i], tour[i + 1]);
+		if(slot != -1)
+			weightSum += g.weights[slot];
+	}
+
+	return weightSum;
+}
+
+/**
+ * Returns the probability of selecting the second node as destination, from 
+ * the first one.
+ *
+ * @param edgeStart The edge's starting point
+ * @param edgeEnd The edge's end point
+ * @return double The probability
+ */
+double AntSystem::prob(int edgeStart, int edgeEnd)
+{	
+	int slot = findSlot(edgeStart, edgeEnd);
+
+	return slot != -1 ? attracts[slot] / rowSums[edgeStart] : 0;
+}
+
+/**
+ * Returns the attraction of an edge, i.e., the numerator of its transition 
+ * probability.
+ *
+ * @param phero The edge's amount of pheromone
+ * @param heu The edge's amount of heuristic information
+ * @return double The attraction
+ */
+double AntSystem::attraction(double phero, double heu)
+{
+	constexpr int alpha = intExponent(A_PAR);
+	constexpr int beta = intExponent(B_PAR);
+	double tau, eta;
+	if constexpr(alpha >= 0)
+		tau = intPower<alpha>(phero);
+	else
+		tau = std::pow(phero, A_PAR);
+	if constexpr(beta >= 0)
+		eta = intPower<beta>(heu);
+	else
+		eta = std::pow(heu, B_PAR);
+
+	return tau * eta;
+}
+
+/**
+ * Recalculates the cached attraction of every edge and the total 
+ * attraction of every node's row after a change of pheromone levels.
+ */
+void AntSystem::refreshAttractions()
+{
+	const Graph& g = *graph;
+	for(int node = 0; node < (int)g.starts.size(); ++node)
+		refreshRow(node);
+}
+
+/**
+ * Recalculates the cached attractions of a node's row and their total.
+ *
+ * @param node The row's node
+ */
+void AntSystem::refreshRow(int node)
+{
+	const Graph& g = *graph;
+	const double* heuristics = guided ? guidance.data() : g.heuristics.data();
+	int first = g.starts[node];
+	int degree = g.degrees[node];
+	double sum = 0;
+	for(int slot = first; slot < first + degree; ++slot)
+		sum += attracts[slot] = static_cast<Level>(attraction(pheros[slot], 
+				heuristics[slot]));
+	rowSums[node] = sum;
+
+	// Rows of hub nodes are sampled in constant time until the next update
+	if(degree >= ALIAS_DEGREE)
+	{
+		if(aliasProbs.size() != g.targets.size())
+		{
+			aliasProbs.resize(g.targets.size());
+			aliasIndices.resize(g.targets.size());
+		}
+		Roulette::buildAlias(&attracts[first], degree, sum, &aliasProbs[first], 
+				&aliasIndices[first]);
+	}
+}
+
+/**
+ * Returns the 'amount' of heuristic information from first input node to 
+ * the second.
+ *
+ * @param edgeStart The edge's starting point
+ * @param edgeEnd The edge's end point
+ * @return double The amount of heuristic information
+ */
+double AntSystem::heuInfo(int edgeStart, int edgeEnd)
+{
+	const Graph& g = *graph;
+	int slot = findSlot(edgeStart, edgeEnd);
+
+	return slot != -1 ? g.heuristics[slot] : 0;
+}
+
+/**
+ * Returns the amount of pheromone from first input node to the second.
+ *
+ * @param edgeStart The edge's starting point
+ * @param edgeEnd The edge's end point
+ * @return double The amount of pheromone
+ */
+double AntSystem::pheromone(int edgeStart, int edgeEnd)
+{
+	int slot = findSlot(edgeStart, edgeEnd);
+
+	return slot != -1 ? pheros[slot] : 0;
+}
+
+/**
+ * Finds all available neighbours of input node.
+ *
+ * @param node The input node
+ * @return std::vector<int> Container with nodes
+ */
+std::vector<int> AntSystem::availNeighbours(int node)
+{
+	const Graph& g = *graph;
+	if(node < 0 || node >= (int)g.starts.size())
+		return std::vector<int>();
+
+	// The outgoing edges of the input node are stored contiguously
+	return std::vector<int>(g.targets.begin() + g.starts[node], 
+			g.targets.begin() + g.starts[node] + g.degrees[node]);
+}
+
+/**
+ * Inserts an edge, touching only the starting node's row. A full row moves 
+ * to the end of the index with twice its capacity and the holes that are 
+ * left behind are reclaimed by an occasional compaction, so the cost is 
+ * amortised constant. Learned pheromone levels are preserved.
+ * 
+ * @param src Source node
+ * @param dest Destination node
+ * @param weight Weight for the edge
+ */
+void AntSystem::insertEdge(int src, int dest, double weight)
+{
+	checkNodes(src, dest);
+	// A row holds one edge per target, so that walks, tour lengths and 
+	// deposits all refer to the same slot
+	if(!loading && findSlot(src, dest) != -1)
+		throw std::invalid_argument("edge " + std::to_string(src) + " -> " 
+				+ std::to_string(dest) + " exists already");
+	Graph& g = writable();
+	AdaptiveSystem::insertEdge(src, dest, weight);
+	int edge = (int)edges.size() - 1;
+	++layout;
+	g.slots.resize(edges.size(), -1);
+	if(loading)
+		return;
+
+	reserveNodes(std::max(src, dest) + 1);
+
+	if(g.degrees[src] == g.capacities[src])
+	{
+		int capacity = std::max(4, 2 * g.capacities[src]);
+		if(g.targets.size() + capacity > 2 * edges.size() + COMPACT_SLACK)
+		{
+			// Compaction places the new edge as well
+			buildIndex();
+			return;
+		}
+		moveRow(src, capacity);
+	}
+
+	int slot = g.starts[src] + g.degrees[src]++;
+	g.targets[slot] = dest;
+	g.weights[slot] = weight;
+	g.heuristics[slot] = 1 / weight;
+	pheros[slot] = static_cast<Level>(PHERO_QUANTITY);
+	g.edgeIndices[slot] = edge;
+	g.slots[edge] = slot;
+	refreshRow(src);
+}
+
+/**
+ * Initialises the topology from a binary snapshot, including the pheromone 
+ * levels when the snapshot carries them. An empty instance copies the 
+ * mapped rows into its adjacency in one sequential pass, without spare 
+ * capacity, and changes its layout once.
+ * 
+ * @param snapshot The memory-mapped snapshot
+ */
+void AntSystem::initSnapshot(const Snapshot& snapshot)
+{
+	// Rows that repeat a target cannot be copied as they are
+	bool repeated = false;
+	std::vector<int> seen(snapshot.nodes(), -1);
+	for(int node = 0; node < snapshot.nodes() && !repeated; ++node)
+		for(std::int64_t edge = snapshot.offsets()[node]; 
+				edge < snapshot.offsets()[node + 1] && !repeated; ++edge)
+		{
+			repeated = seen[snapshot.targets()[edge]] == node;
+			seen[snapshot.targets()[edge]] = node;
+		}
+
+	if(repeated || !edges.empty() || !graph->starts.empty())
+	{
+		// The edges are indexed all at once and then find their levels
+		bool wasLoading = loading;
+		loading = true;
+		AdaptiveSystem::initSnapshot(snapshot);
+		loading = wasLoading;
+		dropDuplicates();
+		buildIndex();
+
+		if(snapshot.pheros())
+			for(int node = 0; node < snapshot.nodes(); ++node)
+				for(std::int64_t edge = snapshot.offsets()[node]; 
+						edge < snapshot.offsets()[node + 1]; ++edge)
+				{
+					int slot = findSlot(node, snapshot.targets()[edge]);
+					if(slot != -1)
+						pheros[slot] = static_cast<Level>(snapshot.pheros()[edge]);
+				}
+		refreshAttractions();
+		return;
+	}
+
+	Graph& g = writable();
+	int nodes = snapshot.nodes();
+	int size = static_cast<int>(snapshot.edges());
+	const std::int64_t* offsets = snapshot.offsets();
+	g.starts.resize(nodes);
+	g.degrees.resize(nodes);
+	for(int node = 0; node < nodes; ++node)
+	{
+		g.starts[node] = static_cast<int>(offsets[node]);
+		g.degrees[node] = static_cast<int>(offsets[node + 1] - offsets[node]);
+	}
+	g.capacities = g.degrees;
+	g.targets.assign(snapshot.targets(), snapshot.targets() + size);
+	g.weights.assign(snapshot.weights(), snapshot.weights() + size);
+	g.heuristics.resize(size);
+	g.edgeIndices.resize(size);
+	g.slots.resize(size);
+	if(snapshot.pheros())
+		pheros.assign(snapshot.pheros(), snapshot.pheros() + size);
+	else
+		pheros.assign(size, static_cast<Level>(PHERO_QUANTITY));
+	edges.resize(size);
+	for(int node = 0; node < nodes; ++node)
+		for(int slot = g.starts[node]; slot < g.starts[node] + g.degrees[node]; ++slot)
+		{
+			g.heuristics[slot] = 1 / g.weights[slot];
+			g.edgeIndices[slot] = g.slots[slot] = slot;
+			edges[slot].edgeStart = node;
+			edges[slot].edgeEnd = g.targets[slot];
+			edges[slot].weight = g.weights[slot];
+			edges[slot].id = slot;
+		}
+	attracts.assign(size, 0);
+	aliasProbs.clear();
+	aliasIndices.clear();
+	rowSums.assign(nodes, 0);
+	++layout;
+	loading = false;
+	refreshAttractions();
+}
+
+/**
+ * Writes the topology along with the learned pheromone levels as a binary 
+ * snapshot.
+ * 
+ * @param filename The snapshot file
+ */
+void AntSystem::saveSnapshot(const std::string& filename)
+{
+	const Graph& g = *graph;
+	int nodes = (int)g.starts.size();
+	std::vector<std::int64_t> offsets(nodes + 1, 0);
+	std::vector<std::int32_t> rowTargets;
+	std::vector<double> rowWeights, rowPheros;
+	rowTargets.reserve(edges.size());
+	rowWeights.reserve(edges.size());
+	rowPheros.reserve(edges.size());
+	for(int node = 0; node < nodes; ++node)
+	{
+		for(int slot = g.starts[node]; slot < g.starts[node] + g.degrees[node]; ++slot)
+		{
+			rowTargets.push_back(g.targets[slot]);
+			rowWeights.push_back(g.weights[slot]);
+			rowPheros.push_back(pheros[slot]);
+		}
+		offsets[node + 1] = (std::int64_t)rowTargets.size();
+	}
+
+	Snapshot::write(filename, offsets, rowTargets, rowWeights, &rowPheros);
+}
+
+/**
+ * Pre-sizes the per-node arrays of the index.
+ *
+ * @param nodes Expected number of nodes
+ */
+void AntSystem::reserveNodes(int nodes)
+{
+	Graph& g = writable();
+	if(nodes > (int)g.starts.size())
+	{
+		g.starts.resize(nodes, 0);
+		g.degrees.resize(nodes, 0);
+		g.capacities.resize(nodes, 0);
+		rowSums.resize(nodes, 0);
+	}
+}
+
+/**
+ * Removes an edge, touching only the starting node's row. The pheromone 
+ * levels of the other edges are preserved.
+ * 
+ * @param src Source node
+ * @param dest Destination node
+ * @return bool The indication of an existing edge being removed
+ */
+bool AntSystem::removeEdge(int src, int dest)
+{
+	// A missing edge leaves a shared topology uncopied
+	checkNodes(src, dest);
+	int slot = findSlot(src, dest);
+	if(slot == -1)
+		return false;
+	Graph& g = writable();
+	++layout;
+
+	// The row's last slot fills the hole
+	int edge = g.edgeIndices[slot];
+	int last = g.starts[src] + --g.degrees[src];
+	g.targets[slot] = g.targets[last];
+	g.weights[slot] = g.weights[last];
+	g.heuristics[slot] = g.heuristics[last];
+	pheros[slot] = pheros[last];
+	g.edgeIndices[slot] = g.edgeIndices[last];
+	g.slots[g.edgeIndices[slot]] = slot;
+
+	// And the last edge fills the hole inside the edges
+	eraseEdge(edge);
+	g.slots[edge] = g.slots.back();
+	g.slots.pop_back();
+	if(edge < (int)edges.size())
+		g.edgeIndices[g.slots[edge]] = edge;
+
+	refreshRow(src);
+	return true;
+}
+
+/**
+ * Updates the weight of an edge, keeping its pheromone level.
+ * 
+ * @param src Source node
+ * @param dest Destination node
+ * @param weight New weight for the edge
+ * @return bool The indication of an existing edge being updated
+ */
+bool AntSystem::updateEdge(int src, int dest, double weight)
+{
+	checkNodes(src, dest);
+	int slot = findSlot(src, dest);
+	if(slot == -1)
+		return false;
+	Graph& g = writable();
+
+	g.weights[slot] = weight;
+	g.heuristics[slot] = 1 / weight;
+	edges[g.edgeIndices[slot]].weight = weight;
+	landmarkLayout = -1;
+	++weightVersion;
+	refreshRow(src);
+	return true;
+}
+
+/**
+ * Moves a node's row to the end of the index with a larger capacity.
+ *
+ * @param node The row's node
+ * @param capacity The new capacity of the row
+ */
+void AntSystem::moveRow(int node, int capacity)
+{
+	Graph& g = writable();
+	int first = (int)g.targets.size();
+	resizeSlots(first + capacity);
+	for(int index = 0; index < g.degrees[node]; ++index)
+	{
+		int from = g.starts[node] + index;
+		int to = first + index;
+		g.targets[to] = g.targets[from];
+		g.weights[to] = g.weights[from];
+		g.heuristics[to] = g.heuristics[from];
+		pheros[to] = pheros[from];
+		g.edgeIndices[to] = g.edgeIndices[from];
+		g.slots[g.edgeIndices[to]] = to;
+	}
+
+	g.starts[node] = first;
+	g.capacities[node] = capacity;
+	refreshRow(node);
+}
+
+/**
+ * Resizes all arrays that are indexed by slots.
+ *
+ * @param size The new number of slots
+ */
+void AntSystem::resizeSlots(int size)
+{
+	Graph& g = writable();
+	g.targets.resize(size);
+	g.weights.resize(size);
+	g.heuristics.resize(size);
+	pheros.resize(size);
+	g.edgeIndices.resize(size);
+	attracts.resize(size);
+	if(!aliasProbs.empty())
+	{
+		aliasProbs.resize(size);
+		aliasIndices.resize(size);
+	}
+}
+
+/**
+ * Rebuilds the compressed-sparse-row adjacency index from the edges, 
+ * leaving some spare capacity in every row. Edges that are already indexed 
+ * keep their pheromone level and the rest start with PHERO_QUANTITY.
+ */
+void AntSystem::buildIndex()
+{
+	Graph& g = writable();
+	int nodes = (int)g.starts.size();
+	for(auto& edge : edges)
+		nodes = std::max(nodes, std::max(edge.edgeStart, edge.edgeEnd) + 1);
+
+	// Count the outgoing edges of each node and lay out the rows
+	std::vector<int> counts(nodes, 0);
+	for(auto& edge : edges)
+		++counts[edge.edgeStart];
+	g.starts.assign(nodes, 0);
+	g.capacities.resize(nodes);
+	int size = 0;
+	for(int node = 0; node < nodes; ++node)
+	{
+		g.starts[node] = size;
+		g.capacities[node] = counts[node] + counts[node] / 4;
+		size += g.capacities[node];
+	}
+
+	// Place every edge inside its starting node's row keeping insertion order
+	Column<int> newTargets(size);
+	Column<double> newWeights(size), newHeuristics(size);
+	Column<Level> newPheros(size);
+	std::vector<int> newEdgeIndices(size);
+	g.slots.resize(edges.size(), -1);
+	g.degrees.assign(nodes, 0);
+	for(int edge = 0; edge < (int)edges.size(); ++edge)
+	{
+		int node = edges[edge].edgeStart;
+		int slot = g.starts[node] + g.degrees[node]++;
+		newTargets[slot] = edges[edge].edgeEnd;
+		newWeights[slot] = edges[edge].weight;
+		newHeuristics[slot] = 1 / edges[edge].weight;
+		newPheros[slot] = g.slots[edge] != -1 ? pheros[g.slots[edge]] 
+				: static_cast<Level>(PHERO_QUANTITY);
+		newEdgeIndices[slot] = edge;
+		g.slots[edge] = slot;
+	}
+
+	g.targets.swap(newTargets);
+	g.weights.swap(newWeights);
+	g.heuristics.swap(newHeuristics);
+	pheros.swap(newPheros);
+	g.edgeIndices.swap(newEdgeIndices);
+	attracts.assign(size, 0);
+	aliasProbs.clear();
+	aliasIndices.clear();
+	rowSums.assign(nodes, 0);
+	refreshAttractions();
+}
+
+/**
+ * Drops the edges that repeat both end points of an earlier edge, keeping 
+ * the slots of the remaining ones.
+ */
+void AntSystem::dropDuplicates()
+{
+	std::vector<int> kept = AdaptiveSystem::dropDuplicates();
+	if(kept.size() == graph->slots.size())
+		return;
+
+	Graph& g = writable();
+	for(int edge = 0; edge < (int)kept.size(); ++edge)
+		g.slots[edge] = g.slots[kept[edge]];
+	g.slots.resize(kept.size());
+}
+
+/**
+ * Finds the index slot of the edge between the input nodes.
+ *
+ * @param edgeStart The edge's starting point
+ * @param edgeEnd The edge's end point
+ * @return int The slot inside the adjacency arrays or -1 if there is no edge
+ */
+int AntSystem::findSlot(int edgeStart, int edgeEnd) const
+{
+	const Graph& g = *graph;
+	if(edgeStart < 0 || edgeStart >= (int)g.starts.size())
+		return -1;
+
+	int first = g.starts[edgeStart];
+	for(int slot = first; slot < first + g.degrees[edgeStart]; ++slot)
+		if(g.targets[slot] == edgeEnd)
+			return slot;
+
+	return -1;
 }
@@ -21,9 +21,11 @@
  *
  */
 
+#include <map>
+#include <list>
+#include <queue>
 #include <unordered_map>
 #include <vector>
-#include <set>
 #include <utility>
 #include <algorithm>
 #include <random>
@@ -31,51 +33,369 @@
 #include <limits>
 #include <iostream>
 #include <string>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include "adaptivesystem.h"
+#include "threadpool.h"
+#include "roulette.h"
+#include "alignedallocator.h"
+#include "xoshiro.h"
 
 #ifndef ANTSYSTEM_H
 #define ANTSYSTEM_H
 
-struct edgeHash
-{
-	size_t operator()(const AdaptiveSystem::Edge& edge) const
-	{
-		return std::hash<long int>()(edge.id);
-	}
-};
-
 class AntSystem : public AdaptiveSystem
 {
+	friend class SharedAntSystem;
+	friend class ExactSystem;
+	friend class DeviceAntSystem;
+
 public:
+	// Why a query stopped
+	enum class StopReason
+	{
+		ITERATIONS,
+		STAGNATION,
+		ENTROPY,
+		DEADLINE
+	};
+
+	// Stopping criteria of a query, each one disabled by a zero value
+	struct StopCriteria
+	{
+		// Iterations in a row without a shorter tour
+		int stagnation = 0;
+		// Normalised entropy upon the best tour's nodes
+		double entropy = 0;
+		std::chrono::milliseconds deadline{0};
+		int maxIterations = 0;
+	};
+
+	// Rule of the pheromone update
+	enum class Rule
+	{
+		// Every successful ant deposits
+		ANT_SYSTEM,
+		// Ant System, with the best tours so far also deposited elitism times
+		ELITIST,
+		// Only the iteration's best or the best tours deposit, within bounds
+		MAX_MIN,
+		// Ant Colony System with local updates and exploitation of the best edge
+		COLONY_SYSTEM
+	};
+
+	struct Strategy
+	{
+		Rule rule = Rule::ANT_SYSTEM;
+		double evaporation = EVAPO_RATE;
+		double elitism = 1;
+		// The best tours so far deposit instead of the iteration's best
+		bool globalBest = false;
+		// The lower bound as a fraction of the upper one
+		double minRatio = 0.01;
+		// Probability of moving along the most attractive edge, kept low since 
+		// greedy moves end in cycles until the trails are learned
+		double exploitation = 0.2;
+		// Weight of the initial level in the local update
+		double localDecay = 0.1;
+		// Half of the ants walk backwards from the destination and join the 
+		// walks of the other half where they meet
+		bool bidirectional = false;
+		// Landmarks whose distances bound the remaining distance to the 
+		// destination within the heuristic information, none when 0
+		int landmarks = 0;
+		// Ants give up once their walk's length, plus the bound of the 
+		// remaining distance with landmarks, exceeds this multiple of the 
+		// shortest tour of the previous iterations, never when 0
+		double pruning = 0;
+	};
+
+	struct Result
+	{
+		std::vector<int> path;
+		double length;
+		int iterations;
+		StopReason reason;
+	};
+
+	// Counters of the colonies run while instrumentation is enabled
+	struct Stats
+	{
+		long colonies = 0;
+		long iterations = 0;
+		// Outcome of every ant's walk
+		long arrived = 0;
+		long cycles = 0;
+		long deadEnds = 0;
+		long pruned = 0;
+		double tourLengths = 0;
+		// Time spent in constructing tours, in calculating their lengths 
+		// summed over the workers and in updating the trails
+		std::chrono::nanoseconds constructTime{0};
+		std::chrono::nanoseconds lengthTime{0};
+		std::chrono::nanoseconds updateTime{0};
+		// Best-so-far length after every iteration of the last colony
+		std::vector<double> trajectory;
+		double averageLength() const;
+		std::string json() const;
+		std::string prometheus() const;
+	};
+
+	// Sends the best tours of a colony to other colonies, e.g., of other 
+	// processes, and returns the best tours received from them
+	typedef std::function<std::vector<std::vector<int>>(
+			const std::vector<std::vector<int>>&)> Migration;
+
+	// Supplies a known path from a source to a destination, e.g., an exact 
+	// one, or an empty path when there is none
+	typedef std::function<std::vector<int>(int, int)> Hint;
+
 	static const int ANTS = 250;
 	static const int ITERATIONS = 150;
 	static const int PHERO_QUANTITY = 100;
 	static constexpr double A_PAR = 1;
 	static constexpr double B_PAR = 5;
 	static constexpr double EVAPO_RATE = 0.5;
+	static const int ALIAS_DEGREE = 64;
+	static const int COMPACT_SLACK = 1024;
 	AntSystem(const std::string&, int = 0, int = 0);
 	AntSystem(int = 0, int = 0);
 	virtual ~AntSystem();
 	virtual std::vector<int> path(int, int);
+	Result query(int, int, const Hint& = nullptr);
+	virtual std::vector<std::vector<int>> paths(std::span<const std::pair<int, int>>);
 	virtual void clear();
 	virtual void insertEdge(int, int, double) noexcept(false);
+	virtual bool removeEdge(int, int);
+	virtual bool updateEdge(int, int, double);
+	virtual void saveSnapshot(const std::string&) noexcept(false);
+	void setThreads(int);
+	void seed(std::uint64_t);
+	void setWarmStart(int, int);
+	void setStopCriteria(const StopCriteria&);
+	void setStrategy(const Strategy&);
+	void savePheromone(const std::string&) const noexcept(false);
+	int restorePheromone(const std::string&) noexcept(false);
+	void setCheckpoint(const std::string&, std::chrono::milliseconds);
+	void setInstrumentation(bool);
+	void setMigration(const Migration&, int);
+	const Stats& stats() const;
+	void resetStats();
 
 private:
+	// Contiguous per-slot array aligned for vector loads
+	template<class T>
+	using Column = std::vector<T, AlignedAllocator<T>>;
+
+	// Precision of pheromone levels and attractions
+#ifdef ACOPATH_FLOAT_PHEROMONE
+	typedef float Level;
+#else
+	typedef double Level;
+#endif
+
+	// Scratch buffers and random stream reused by the walks of a worker, on 
+	// their own cache lines
+	struct alignas(64) Walker
+	{
+		Xoshiro256 gen;
+		// Nodes stamped with the current epoch are visited by the current walk
+		std::vector<unsigned int> stamps;
+		unsigned int epoch = 0;
+		// Counters of the current colony
+		long arrived = 0;
+		long cycles = 0;
+		long deadEnds = 0;
+		long pruned = 0;
+		double tourLengths = 0;
+		std::chrono::nanoseconds lengthTime{0};
+		// Length of the current walk so far and its bound
+		double length = 0;
+		double limit = 0;
+		// Walks of a backward ant before and after joining
+		std::vector<int> backward;
+		std::vector<int> joined;
+		void begin(int);
+	};
+
+	// Compressed-sparse-row adjacency with spare capacity: the outgoing edges 
+	// of node n occupy the slots [starts[n], starts[n] + degrees[n]) of the 
+	// remaining arrays and the row can grow in place up to capacities[n]
+	struct Graph
+	{
+		std::vector<int> starts;
+		std::vector<int> degrees;
+		std::vector<int> capacities;
+		Column<int> targets;
+		Column<double> weights;
+		// Heuristic information, i.e., the inverse weights
+		Column<double> heuristics;
+		// Position inside the edges of every slot's edge and vice versa
+		std::vector<int> edgeIndices;
+		std::vector<int> slots;
+	};
+
+	// Tours of an iteration's ants, stored back to back in one buffer per 
+	// worker and indexed by ant number, so no allocation happens once the 
+	// buffers have grown enough
+	struct Tours
+	{
+		struct Entry
+		{
+			int worker;
+			int offset;
+			int size;
+			double length;
+		};
+
+		// A buffer per cache line, as it grows while the others do
+		struct alignas(64) Buffer
+		{
+			std::vector<int> nodes;
+		};
+
+		std::vector<Entry> entries;
+		std::vector<Buffer> buffers;
+		void reset(int, int);
+		std::span<const int> trace(int) const;
+	};
+
+	// Pheromone levels learned for a destination
+	struct Table
+	{
+		Column<Level> pheros;
+		// Best tour per source
+		std::unordered_map<int, std::vector<int>> bests;
+		long int layout;
+		std::list<int>::iterator position;
+	};
+
+	// Shortest walk of a forward ant that visited a node, per source group
+	struct Meeting
+	{
+		unsigned int stamp = 0;
+		int ant;
+		int position;
+		double length;
+	};
+
+	AntSystem(std::shared_ptr<Graph>, int, int);
 	void init(int, int);
+	Graph& writable();
+	void adopt(const std::shared_ptr<Graph>&);
+	virtual void reserveNodes(int);
+	virtual void initSnapshot(const Snapshot&);
+	const Table* restoreTable(int);
+	void storeTable(int, const std::vector<Result>&);
+	void evictTable();
 	double prob(int, int);
+	static double attraction(double, double);
+	void refreshAttractions();
+	void refreshRow(int);
+	virtual std::vector<Result> colony(const std::vector<int>&, int, const Hint& = nullptr);
+	void layHints(const std::vector<int>&, int, const Hint&);
+	bool converged(const std::vector<Result>&);
+	bool migrate(const std::vector<int>&, int, std::vector<Result>&, 
+			std::vector<double>&);
+	void checkpoint();
+	double entropy(const std::vector<int>&);
 	double heuInfo(int, int);
 	double pheromone(int, int);
 	virtual double diffPheromone(double);
 	std::vector<int> availNeighbours(int);
-	virtual void updateTrails(std::map<int, std::vector<int>>&, 
-			std::map<int, double>&);
-	virtual void goAnt(int, int, std::vector<int>&);
-	virtual double calcTourLength(std::vector<int>&);
-	bool isCyclic(int, const std::vector<int>&);
-	std::unordered_map<AdaptiveSystem::Edge, double, edgeHash> edge2phero;
+	virtual void updateTrails(const Tours&, const std::vector<Result>&);
+	void deposit(std::span<const int>, double, Level);
+	virtual void goAnt(int, int, std::vector<int>&, Walker&);
+	virtual double calcTourLength(std::span<const int>);
+	template<bool BACKWARD>
+	bool walk(int, int, std::vector<int>&, Walker&, int);
+	void joinAnt(int, int, int, int, std::vector<int>&, Walker&);
+	void markMeetings(int);
+	void buildReverse();
+	void refreshReverse();
+	void guide(const std::vector<int>&, int);
+	void buildLandmarks(int);
+	void distances(int, bool, double*);
+	double bound(int, int) const;
+	void buildIndex();
+	void dropDuplicates();
+	void moveRow(int, int);
+	void resizeSlots(int);
+	int findSlot(int, int) const;
+	// The topology, shared read-only with other instances and copied by 
+	// writable() before its first change
+	std::shared_ptr<Graph> graph;
+	// Pheromone level of every slot of the graph
+	Column<Level> pheros;
+	// Cached tau^A_PAR * eta^B_PAR of every slot and their sum per node
+	Column<Level> attracts;
+	std::vector<double> rowSums;
+	// Alias tables of the rows with at least ALIAS_DEGREE slots
+	std::vector<Level> aliasProbs;
+	std::vector<int> aliasIndices;
 	int ants;
 	int iterations;
-	std::mt19937_64 gen;
+	std::uint64_t seedValue;
+	// Streams drawn since the last seeding
+	std::uint64_t streams;
+	// One walker per worker of the pool
+	std::vector<Walker> walkers;
+	Tours tours;
+	// Walks of the forward ants in bidirectional mode, kept even when failed
+	Tours explorations;
+	int forwardAnts;
+	std::vector<Meeting> meetings;
+	unsigned int meetEpoch;
+	// Reversed adjacency: the edges ending at node n occupy the positions 
+	// [reverseStarts[n], reverseStarts[n + 1]), built for reverseLayout
+	std::vector<int> reverseStarts;
+	std::vector<int> reverseSources;
+	std::vector<int> reverseSlots;
+	Column<Level> reverseAttracts;
+	std::vector<double> reverseSums;
+	long int reverseLayout;
+	// Distances from and to every landmark, landmark after landmark, upon 
+	// the topology and weights of landmarkLayout
+	std::vector<double> fromLandmarks;
+	std::vector<double> toLandmarks;
+	long int landmarkLayout;
+	// Heuristic information towards the destination of the running colony 
+	// and the bound of every node's remaining distance to it
+	Column<double> guidance;
+	std::vector<double> remaining;
+	bool guided;
+	std::unique_ptr<ThreadPool> pool;
+	// Cached tables per destination, with the most recently used first
+	std::unordered_map<int, Table> tables;
+	std::list<int> recency;
+	int tableCapacity;
+	int warmIterations;
+	StopCriteria criteria;
+	Strategy strategy;
+	// Length of the first tour of the current colony
+	double referenceLength;
+	std::string checkpointFile;
+	std::chrono::milliseconds checkpointInterval;
+	std::chrono::steady_clock::time_point lastCheckpoint;
+	bool instrumented;
+	Migration migration;
+	int migrationInterval;
+	Stats statistics;
+	// Set while the topology file is read
+	bool loading;
+	// Changes whenever slots are added, moved or removed
+	long int layout;
+	// Changes whenever a weight is updated
+	long int weightVersion;
+	// Layout and weight version when the hint of every source was laid, per 
+	// destination, dropped along with the pheromone holding the hints
+	std::unordered_map<int, std::unordered_map<int, std::pair<long int, long int>>> hinted;
 };
 
 #endif // ANTSYSTEM_H
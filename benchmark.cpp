@@ -0,0 +1,795 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <filesystem>
+#include <set>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <iomanip>
+#include <numbers>
+#include <thread>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+#include "antsystem.h"
+
+/**
+ * Synthetic topology in compressed-sparse-row form.
+ */
+struct Graph
+{
+	int nodes = 0;
+	std::vector<std::int64_t> offsets;
+	std::vector<std::int32_t> targets;
+	std::vector<double> weights;
+};
+
+/**
+ * Collects undirected links and turns them into a graph, where every link
+ * becomes an edge in each direction. A link repeating the end points of an 
+ * earlier one is ignored, as it is by the colonies, so that the exact 
+ * distances refer to the same graph.
+ */
+class Links
+{
+public:
+	explicit Links(int nodes) : nodes(nodes) { }
+	void add(int src, int dest, double weight)
+	{
+		if(src != dest)
+			links.push_back({src, dest, weight});
+	}
+	Graph graph() const;
+
+private:
+	struct Link
+	{
+		int src;
+		int dest;
+		double weight;
+	};
+
+	int nodes;
+	std::vector<Link> links;
+};
+
+/**
+ * Sorts the edges of both directions by starting node.
+ *
+ * @return Graph The graph
+ */
+Graph Links::graph() const
+{
+	std::vector<Link> kept;
+	std::set<std::pair<int, int>> seen;
+	for(auto& link : links)
+		if(seen.insert(std::minmax(link.src, link.dest)).second)
+			kept.push_back(link);
+
+	Graph graph;
+	graph.nodes = nodes;
+	graph.offsets.assign(nodes + 1, 0);
+	for(auto& link : kept)
+	{
+		++graph.offsets[link.src + 1];
+		++graph.offsets[link.dest + 1];
+	}
+	for(int node = 0; node < nodes; ++node)
+		graph.offsets[node + 1] += graph.offsets[node];
+
+	std::vector<std::int64_t> next(graph.offsets.begin(), graph.offsets.end() - 1);
+	graph.targets.resize(2 * kept.size());
+	graph.weights.resize(2 * kept.size());
+	for(auto& link : kept)
+	{
+		std::int64_t pos = next[link.src]++;
+		graph.targets[pos] = link.dest;
+		graph.weights[pos] = link.weight;
+		pos = next[link.dest]++;
+		graph.targets[pos] = link.src;
+		graph.weights[pos] = link.weight;
+	}
+
+	return graph;
+}
+
+/**
+ * Square-ish grid where every node links to its right and lower neighbours.
+ *
+ * @param nodes Number of nodes
+ * @param gen Random stream for the weights
+ * @return Graph The grid
+ */
+static Graph grid(int nodes, std::mt19937_64& gen)
+{
+	std::uniform_real_distribution<> weight(1, 100);
+	int width = std::max(1, static_cast<int>(std::ceil(std::sqrt(nodes))));
+	Links links(nodes);
+	for(int node = 0; node < nodes; ++node)
+	{
+		if((node + 1) % width && node + 1 < nodes)
+			links.add(node, node + 1, weight(gen));
+		if(node + width < nodes)
+			links.add(node, node + width, weight(gen));
+	}
+
+	return links.graph();
+}
+
+/**
+ * Random geometric graph in the unit square, linking the points closer than
+ * the radius that gives an average degree of about eight. The weights are
+ * the scaled distances.
+ *
+ * @param nodes Number of nodes
+ * @param gen Random stream for the positions
+ * @return Graph The graph
+ */
+static Graph geometric(int nodes, std::mt19937_64& gen)
+{
+	std::uniform_real_distribution<> coord(0, 1);
+	std::vector<double> xs(nodes), ys(nodes);
+	for(int node = 0; node < nodes; ++node)
+	{
+		xs[node] = coord(gen);
+		ys[node] = coord(gen);
+	}
+
+	// Bucket the points in cells as wide as the radius, so that only the
+	// neighbouring cells are searched
+	double radius = std::sqrt(8.0 / (std::numbers::pi * std::max(nodes, 1)));
+	int cells = std::max(1, static_cast<int>(1 / radius));
+	auto cellOf = [cells](double coord)
+	{
+		return std::min(cells - 1, static_cast<int>(coord * cells));
+	};
+	std::vector<std::vector<int>> buckets(cells * cells);
+	for(int node = 0; node < nodes; ++node)
+		buckets[cellOf(ys[node]) * cells + cellOf(xs[node])].push_back(node);
+
+	Links links(nodes);
+	for(int node = 0; node < nodes; ++node)
+	{
+		int cx = cellOf(xs[node]), cy = cellOf(ys[node]);
+		for(int y = std::max(0, cy - 1); y <= std::min(cells - 1, cy + 1); ++y)
+			for(int x = std::max(0, cx - 1); x <= std::min(cells - 1, cx + 1); ++x)
+				for(int other : buckets[y * cells + x])
+				{
+					double distance = std::hypot(xs[node] - xs[other], ys[node] - ys[other]);
+					if(other > node && distance <= radius)
+						links.add(node, other, 1 + 1000 * distance);
+				}
+	}
+
+	return links.graph();
+}
+
+/**
+ * Scale-free graph by preferential attachment, where every new node links
+ * to two earlier nodes picked in proportion to their degree.
+ *
+ * @param nodes Number of nodes
+ * @param gen Random stream for the attachments and weights
+ * @return Graph The graph
+ */
+static Graph scaleFree(int nodes, std::mt19937_64& gen)
+{
+	const int LINKS = 2;
+	std::uniform_real_distribution<> weight(1, 100);
+	Links links(nodes);
+	// Every node appears once per incident link
+	std::vector<int> ends;
+	for(int node = 1; node < std::min(nodes, LINKS + 1); ++node)
+		for(int other = 0; other < node; ++other)
+		{
+			links.add(node, other, weight(gen));
+			ends.push_back(node);
+			ends.push_back(other);
+		}
+
+	for(int node = LINKS + 1; node < nodes; ++node)
+	{
+		int chosen[LINKS];
+		for(int link = 0; link < LINKS; ++link)
+		{
+			do
+				chosen[link] = ends[gen() % ends.size()];
+			while(link > 0 && chosen[link] == chosen[0]);
+			links.add(node, chosen[link], weight(gen));
+		}
+		for(int link = 0; link < LINKS; ++link)
+		{
+			ends.push_back(node);
+			ends.push_back(chosen[link]);
+		}
+	}
+
+	return links.graph();
+}
+
+/**
+ * ISP-like hierarchy of a meshed core, an aggregation tier where every
+ * router is dual-homed to the core and ringed with its neighbours, and an
+ * access tier hanging from the aggregation routers, a third of it
+ * dual-homed. Weights grow towards the edge of the network.
+ *
+ * @param nodes Number of nodes
+ * @param gen Random stream for the attachments and weights
+ * @return Graph The graph
+ */
+static Graph isp(int nodes, std::mt19937_64& gen)
+{
+	std::uniform_real_distribution<> coreWeight(1, 10), aggrWeight(10, 50),
+			accessWeight(50, 100), chance(0, 1);
+	int core = std::clamp(nodes / 1000, std::min(nodes, 4), 32);
+	int aggregation = std::max(1, std::min(nodes - core, nodes / 20));
+	Links links(nodes);
+	for(int node = 0; node < core; ++node)
+		for(int other = node + 1; other < core; ++other)
+			links.add(node, other, coreWeight(gen));
+
+	for(int node = core; node < core + aggregation; ++node)
+	{
+		int index = node - core;
+		links.add(node, index % core, aggrWeight(gen));
+		if(core > 1)
+			links.add(node, (index + 1) % core, aggrWeight(gen));
+		if(index > 0)
+			links.add(node, node - 1, aggrWeight(gen));
+	}
+
+	for(int node = core + aggregation; node < nodes; ++node)
+	{
+		int parent = core + static_cast<int>(gen() % aggregation);
+		links.add(node, parent, accessWeight(gen));
+		// The second parent differs from the first one
+		if(aggregation > 1 && chance(gen) < 1.0 / 3)
+			links.add(node, core + static_cast<int>((parent - core + 1 
+					+ gen() % (aggregation - 1)) % aggregation), accessWeight(gen));
+	}
+
+	return links.graph();
+}
+
+/**
+ * Exact shortest distances from a source node.
+ *
+ * @param graph The graph
+ * @param src The source node
+ * @return std::vector<double> The distances, infinite for unreachable nodes
+ */
+static std::vector<double> dijkstra(const Graph& graph, int src)
+{
+	typedef std::pair<double, int> Entry;
+	std::vector<double> dists(graph.nodes, std::numeric_limits<double>::infinity());
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+	dists[src] = 0;
+	queue.push({0, src});
+	while(!queue.empty())
+	{
+		auto [dist, node] = queue.top();
+		queue.pop();
+		if(dist > dists[node])
+			continue;
+		for(std::int64_t edge = graph.offsets[node]; edge < graph.offsets[node + 1]; ++edge)
+		{
+			double next = dist + graph.weights[edge];
+			if(next < dists[graph.targets[edge]])
+			{
+				dists[graph.targets[edge]] = next;
+				queue.push({next, graph.targets[edge]});
+			}
+		}
+	}
+
+	return dists;
+}
+
+/**
+ * Resident memory of the process.
+ *
+ * @return long The resident memory in KiB, or 0 where it is unknown
+ */
+static long residentMemory()
+{
+#if defined(__unix__) || defined(__APPLE__)
+	std::ifstream statm("/proc/self/statm");
+	long pages, resident;
+	if(statm >> pages >> resident)
+		return resident * (sysconf(_SC_PAGESIZE) / 1024);
+
+	// Peak instead of current memory where procfs is missing, which macOS 
+	// reports in bytes
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#else
+	return 0;
+#endif
+}
+
+/**
+ * Tag that keeps the temporary files of concurrent runs apart.
+ *
+ * @return std::string The process ID, or a random number where unknown
+ */
+static std::string processTag()
+{
+#if defined(__unix__) || defined(__APPLE__)
+	return std::to_string(getpid());
+#else
+	return std::to_string(std::random_device()());
+#endif
+}
+
+/**
+ * Query with a known optimal length.
+ */
+struct Query
+{
+	int src;
+	int dest;
+	double optimal;
+};
+
+/**
+ * Picks random pairs whose destination is reachable from the source.
+ *
+ * @param graph The graph
+ * @param count Number of pairs
+ * @param gen Random stream for the pairs
+ * @return std::vector<Query> The pairs along with their optimal lengths
+ */
+static std::vector<Query> queries(const Graph& graph, int count, std::mt19937_64& gen)
+{
+	std::vector<Query> picked;
+	for(int attempt = 0; (int)picked.size() < count && attempt < 10 * count; ++attempt)
+	{
+		int src = static_cast<int>(gen() % graph.nodes);
+		std::vector<double> dists = dijkstra(graph, src);
+		std::vector<int> reachable;
+		for(int node = 0; node < graph.nodes; ++node)
+			if(node != src && std::isfinite(dists[node]))
+				reachable.push_back(node);
+		if(reachable.empty())
+			continue;
+		int dest = reachable[gen() % reachable.size()];
+		picked.push_back({src, dest, dists[dest]});
+	}
+
+	return picked;
+}
+
+/**
+ * Value at a quantile of sorted samples.
+ *
+ * @param sorted The sorted samples
+ * @param quantile The quantile in range [0, 1]
+ * @return double The value
+ */
+static double percentile(const std::vector<double>& sorted, double quantile)
+{
+	if(sorted.empty())
+		return 0;
+
+	return sorted[std::min(sorted.size() - 1,
+			static_cast<size_t>(quantile * sorted.size()))];
+}
+
+/**
+ * Parses a comma-separated list of values.
+ *
+ * @param list The list
+ * @return std::vector<std::string> The values
+ */
+static std::vector<std::string> split(const std::string& list)
+{
+	std::vector<std::string> values;
+	std::stringstream stream(list);
+	for(std::string value; std::getline(stream, value, ',');)
+		if(!value.empty())
+			values.push_back(value);
+
+	return values;
+}
+
+/**
+ * Parses a comma-separated list of integers.
+ *
+ * @param list The list
+ * @return std::vector<int> The integers
+ */
+static std::vector<int> integers(const std::string& list)
+{
+	std::vector<int> values;
+	for(auto& value : split(list))
+		values.push_back(static_cast<int>(std::stod(value)));
+
+	return values;
+}
+
+/**
+ * Reads a topology file, in JSON format or as a snapshot, keeping the 
+ * direction of every edge.
+ *
+ * @param filename The topology file
+ * @return Graph The graph
+ */
+static Graph load(const std::string& filename)
+{
+	Graph graph;
+	if(Snapshot::probe(filename))
+	{
+		Snapshot snapshot(filename);
+		graph.nodes = snapshot.nodes();
+		graph.offsets.assign(snapshot.offsets(), snapshot.offsets() + graph.nodes + 1);
+		graph.targets.assign(snapshot.targets(), snapshot.targets() + snapshot.edges());
+		graph.weights.assign(snapshot.weights(), snapshot.weights() + snapshot.edges());
+		return graph;
+	}
+
+	struct Edge
+	{
+		int src;
+		int dest;
+		double weight;
+	};
+	std::vector<Edge> edges;
+	TopologyReader reader(filename);
+	reader.read([&graph](int nodes) { graph.nodes = std::max(graph.nodes, nodes); },
+			[&graph, &edges](int src, int dest, double weight)
+			{
+				edges.push_back({src, dest, weight});
+				graph.nodes = std::max(graph.nodes, std::max(src, dest) + 1);
+			});
+	graph.offsets.assign(graph.nodes + 1, 0);
+	for(auto& edge : edges)
+		++graph.offsets[edge.src + 1];
+	for(int node = 0; node < graph.nodes; ++node)
+		graph.offsets[node + 1] += graph.offsets[node];
+	std::vector<std::int64_t> next(graph.offsets.begin(), graph.offsets.end() - 1);
+	graph.targets.resize(edges.size());
+	graph.weights.resize(edges.size());
+	for(auto& edge : edges)
+	{
+		std::int64_t pos = next[edge.src]++;
+		graph.targets[pos] = edge.dest;
+		graph.weights[pos] = edge.weight;
+	}
+
+	return graph;
+}
+
+/**
+ * Outcome of the queries upon one configuration.
+ */
+struct Run
+{
+	double loadTime = 0;
+	// Sorted latencies of the queries
+	std::vector<double> latencies;
+	double total = 0;
+	long walks = 0;
+	int found = 0;
+	// Paths at least as good as the required quality
+	int succeeded = 0;
+	double quality = 0;
+};
+
+/**
+ * Answers the queries upon a fresh instance, since queries share the trails.
+ *
+ * @param snapshot The topology's snapshot
+ * @param pairs The queries
+ * @param ants Number of ants
+ * @param iterations Number of iterations
+ * @param threads Number of threads
+ * @param landmarks Number of landmarks
+ * @param seed The seed of the ants
+ * @param required Quality for a path to count as a success
+ * @return Run The outcome
+ */
+static Run measure(const std::string& snapshot, const std::vector<Query>& pairs,
+		int ants, int iterations, int threads, int landmarks, std::uint64_t seed,
+		double required)
+{
+	Run run;
+	auto loadStart = std::chrono::steady_clock::now();
+	AntSystem aco(snapshot, ants, iterations);
+	run.loadTime = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - loadStart).count();
+	aco.setThreads(threads);
+	aco.seed(seed);
+	AntSystem::Strategy strategy;
+	strategy.landmarks = landmarks;
+	aco.setStrategy(strategy);
+	for(auto& pair : pairs)
+	{
+		auto start = std::chrono::steady_clock::now();
+		AntSystem::Result result = aco.query(pair.src, pair.dest);
+		run.latencies.push_back(std::chrono::duration<double, std::milli>(
+				std::chrono::steady_clock::now() - start).count());
+		run.walks += static_cast<long>(ants) * result.iterations;
+		if(!result.path.empty())
+		{
+			double quality = result.length > 0 ? pair.optimal / result.length : 1;
+			++run.found;
+			run.quality += quality;
+			if(quality >= required - 1e-9)
+				++run.succeeded;
+		}
+	}
+
+	std::sort(run.latencies.begin(), run.latencies.end());
+	for(double latency : run.latencies)
+		run.total += latency;
+	return run;
+}
+
+/**
+ * FNV-1a hash of a file's contents, which tells whether a cached 
+ * calibration still matches the topology.
+ *
+ * @param filename The file
+ * @return std::uint64_t The hash
+ */
+static std::uint64_t fingerprint(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	std::uint64_t hash = 0xcbf29ce484222325;
+	char buffer[1 << 16];
+	while(file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+		for(std::streamsize i = 0; i < file.gcount(); ++i)
+		{
+			hash ^= static_cast<unsigned char>(buffer[i]);
+			hash *= 0x100000001b3;
+		}
+
+	return hash;
+}
+
+/**
+ * Reads a calibration of key and value lines.
+ *
+ * @param filename The calibration file
+ * @return std::map<std::string, std::string> The values, none without a file
+ */
+static std::map<std::string, std::string> readCalibration(const std::string& filename)
+{
+	std::map<std::string, std::string> values;
+	std::ifstream file(filename);
+	std::string key, value;
+	while(file >> key >> value)
+		values[key] = value;
+
+	return values;
+}
+
+static void usage(const char* name)
+{
+	std::cerr << "Usage: " << name << " [options]" << std::endl
+			<< "  --kinds grid,geometric,scalefree,isp" << std::endl
+			<< "  --sizes 100,1000,10000 (up to 1e6)" << std::endl
+			<< "  --threads 1,N" << std::endl
+			<< "  --ants " << AntSystem::ANTS << ",..." << std::endl
+			<< "  --iterations " << AntSystem::ITERATIONS << ",..." << std::endl
+			<< "  --landmarks 0,..." << std::endl
+			<< "  --queries 20" << std::endl
+			<< "  --seed 1" << std::endl
+			<< "  --topology FILE (instead of the kinds and sizes)" << std::endl
+			<< "  --calibrate RATE (of successes, searching the cheapest configuration)"
+			<< std::endl
+			<< "  --quality 1 (of a success, i.e., the Dijkstra distance over the length)"
+			<< std::endl
+			<< "  --budget MS (of the 90th percentile latency)" << std::endl;
+}
+
+/**
+ * Writes the calibration of a topology next to it.
+ *
+ * @param filename The calibration file
+ * @param values The values
+ */
+static void writeCalibration(const std::string& filename,
+		const std::map<std::string, std::string>& values)
+{
+	std::ofstream file(filename);
+	for(auto& [key, value] : values)
+		file << key << " " << value << std::endl;
+	if(!file)
+		throw std::runtime_error(filename + ": cannot write calibration");
+}
+
+int main(int argc, char *argv[])
+{
+	std::map<std::string, std::function<Graph(int, std::mt19937_64&)>> generators = {
+			{"grid", grid}, {"geometric", geometric}, {"scalefree", scaleFree},
+			{"isp", isp}};
+	int cores = static_cast<int>(std::thread::hardware_concurrency());
+	std::map<std::string, std::string> options = {
+			{"--kinds", "grid,geometric,scalefree,isp"}, {"--sizes", "100,1000,10000"},
+			{"--threads", cores > 1 ? "1," + std::to_string(cores) : "1"},
+			{"--ants", std::to_string(AntSystem::ANTS)},
+			{"--iterations", std::to_string(AntSystem::ITERATIONS)},
+			{"--landmarks", "0"}, {"--queries", "20"}, {"--seed", "1"},
+			{"--topology", ""}, {"--calibrate", ""}, {"--quality", "1"}, {"--budget", ""}};
+	std::set<std::string> given;
+	for(int arg = 1; arg < argc; ++arg)
+	{
+		if(!options.count(argv[arg]) || arg + 1 == argc)
+		{
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		options[argv[arg]] = argv[arg + 1];
+		given.insert(argv[arg]);
+		++arg;
+	}
+
+	// Calibration searches a wider space unless the caller narrows it
+	bool calibrating = !options["--calibrate"].empty();
+	if(calibrating)
+	{
+		if(!given.count("--ants"))
+			options["--ants"] = "10,25,50,100,250";
+		if(!given.count("--iterations"))
+			options["--iterations"] = "10,25,50,100,150";
+		if(!given.count("--landmarks"))
+			options["--landmarks"] = "0,8";
+	}
+
+	std::string snapshot = (std::filesystem::temp_directory_path()
+			/ ("acopath-bench-" + processTag() + ".snap")).string();
+	try
+	{
+		std::uint64_t seed = std::stoull(options["--seed"]);
+		double target = calibrating ? std::stod(options["--calibrate"]) : 0;
+		double required = std::stod(options["--quality"]);
+		double budget = options["--budget"].empty() ? 0 : std::stod(options["--budget"]);
+		std::string topology = options["--topology"];
+		std::string cache = topology + ".tuning";
+		std::map<std::string, std::string> targets;
+		if(calibrating && !topology.empty())
+		{
+			std::ostringstream hash;
+			hash << std::hex << fingerprint(topology);
+			targets = {{"fingerprint", hash.str()}, {"success", options["--calibrate"]},
+					{"quality", options["--quality"]}, {"budget", options["--budget"].empty()
+					? "none" : options["--budget"]}};
+			std::map<std::string, std::string> cached = readCalibration(cache);
+			if(std::all_of(targets.begin(), targets.end(), [&cached](auto& value)
+					{ return cached.count(value.first) && cached[value.first] == value.second; }))
+			{
+				std::cout << "cached " << topology << ": ants " << cached["ants"]
+						<< " iterations " << cached["iterations"] << " landmarks "
+						<< cached["landmarks"] << " threads " << cached["threads"]
+						<< " p90_ms " << cached["p90_ms"] << " success " << cached["success_rate"]
+						<< std::endl;
+				return EXIT_SUCCESS;
+			}
+		}
+
+		std::cout << "kind\tnodes\tedges\tthreads\tants\titers\tlandmarks\tload_ms\tp50_ms"
+				"\tp90_ms\tp99_ms\tmax_ms\tants_per_s\tfound\tsuccess\tquality\trss_kib"
+				<< std::endl;
+		auto bench = [&](const std::string& kind, const Graph& graph, std::mt19937_64& gen)
+		{
+			std::vector<Query> pairs = queries(graph, std::stoi(options["--queries"]), gen);
+			Snapshot::write(snapshot, graph.offsets, graph.targets, graph.weights);
+
+			// The cheapest configuration meeting the targets, by its 90th percentile
+			bool chosen = false;
+			double bestLatency = 0, bestRate = -1;
+			std::map<std::string, std::string> best;
+			for(int landmarks : integers(options["--landmarks"]))
+				for(int threads : integers(options["--threads"]))
+					for(int ants : integers(options["--ants"]))
+						for(int iterations : integers(options["--iterations"]))
+						{
+							Run run = measure(snapshot, pairs, ants, iterations, threads,
+									landmarks, seed, required);
+							double p90 = percentile(run.latencies, 0.9);
+							double rate = pairs.empty() ? 0 : static_cast<double>(run.succeeded)
+									/ pairs.size();
+							std::cout << std::fixed << std::setprecision(3) << kind << "\t"
+									<< graph.nodes << "\t" << graph.targets.size() << "\t"
+									<< threads << "\t" << ants << "\t" << iterations << "\t"
+									<< landmarks << "\t" << run.loadTime << "\t"
+									<< percentile(run.latencies, 0.5) << "\t" << p90 << "\t"
+									<< percentile(run.latencies, 0.99) << "\t"
+									<< percentile(run.latencies, 1) << "\t" << std::setprecision(0)
+									<< (run.total > 0 ? run.walks / run.total * 1000 : 0) << "\t"
+									<< run.found << "/" << pairs.size() << "\t" << run.succeeded
+									<< "/" << pairs.size() << "\t" << std::setprecision(3)
+									<< (run.found ? run.quality / run.found : 0) << "\t"
+									<< residentMemory() << std::endl;
+							if(!calibrating)
+								continue;
+
+							bool meets = rate >= target - 1e-9 && (budget <= 0 || p90 <= budget);
+							if(meets ? !chosen || p90 < bestLatency : !chosen && rate > bestRate)
+							{
+								chosen = meets;
+								bestLatency = p90;
+								bestRate = rate;
+								std::ostringstream latency, success;
+								latency << std::fixed << std::setprecision(3) << p90;
+								success << std::fixed << std::setprecision(3) << rate;
+								best = {{"ants", std::to_string(ants)},
+										{"iterations", std::to_string(iterations)},
+										{"landmarks", std::to_string(landmarks)},
+										{"threads", std::to_string(threads)},
+										{"p90_ms", latency.str()}, {"success_rate", success.str()}};
+							}
+							// More iterations only add latency once the targets are met
+							if(meets)
+								break;
+						}
+
+			if(!calibrating)
+				return;
+			std::cout << (chosen ? "best " : "unmet, closest ") << kind << " "
+					<< graph.nodes << ": ants " << best["ants"] << " iterations "
+					<< best["iterations"] << " landmarks " << best["landmarks"] << " threads "
+					<< best["threads"] << " p90_ms " << best["p90_ms"] << " success "
+					<< best["success_rate"] << std::endl;
+			if(chosen && !topology.empty())
+			{
+				best.insert(targets.begin(), targets.end());
+				writeCalibration(cache, best);
+			}
+		};
+
+		if(!topology.empty())
+		{
+			std::mt19937_64 gen(seed);
+			bench(std::filesystem::path(topology).filename().string(), load(topology), gen);
+		}
+		else
+			for(auto& kind : split(options["--kinds"]))
+			{
+				if(!generators.count(kind))
+					throw std::runtime_error(kind + ": unknown topology kind");
+				for(int nodes : integers(options["--sizes"]))
+				{
+					std::mt19937_64 gen(seed);
+					bench(kind, generators[kind](std::max(nodes, 2), gen), gen);
+				}
+			}
+	}
+	catch(std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		std::filesystem::remove(snapshot);
+		return EXIT_FAILURE;
+	}
+
+	std::filesystem::remove(snapshot);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,984 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "deviceantsystem.h"
+
+#ifdef ACOPATH_OPENCL
+#define CL_TARGET_OPENCL_VERSION 120
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+// Outcomes of a walk, as set by the construct kernel
+static const int ARRIVED = 0;
+static const int CYCLE = 1;
+static const int DEAD_END = 2;
+static const int PRUNED = 3;
+
+// The colony's kernels in OpenCL C, built with LEVEL, LEVEL_MIN, the integer
+// exponents ALPHA and BETA, or -1 for pow() with A_PAR and B_PAR, defined.
+// Walks, random streams, sampling and attractions follow the CPU code step
+// by step, except that the rows of hubs are sampled without alias tables.
+static const char* KERNELS = R"(
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
+#pragma OPENCL FP_CONTRACT OFF
+
+#define ARRIVED 0
+#define CYCLE 1
+#define DEAD_END 2
+#define PRUNED 3
+#define GOLDEN 0x9e3779b97f4a7c15UL
+
+/* Xoshiro256** seeded by SplitMix64, as in xoshiro.h */
+typedef struct
+{
+	ulong state[4];
+} Xoshiro;
+
+ulong rotl(ulong x, int bits)
+{
+	return (x << bits) | (x >> (64 - bits));
+}
+
+ulong finalise(ulong x)
+{
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9UL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebUL;
+	return x ^ (x >> 31);
+}
+
+void seedStream(Xoshiro* gen, ulong value, ulong stream)
+{
+	for(int word = 0; word < 4; ++word)
+		gen->state[word] = finalise(value + (stream * 4 + word + 1) * GOLDEN);
+}
+
+ulong nextWord(Xoshiro* gen)
+{
+	ulong* state = gen->state;
+	ulong result = rotl(state[1] * 5, 7) * 9;
+	ulong shifted = state[1] << 17;
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= shifted;
+	state[3] = rotl(state[3], 45);
+	return result;
+}
+
+double uniformDraw(Xoshiro* gen)
+{
+	return (nextWord(gen) >> 11) * 0x1.0p-53;
+}
+
+/* Scalar roulette of Roulette::scan */
+int spin(__global const LEVEL* weights, int size, LEVEL value)
+{
+	int index = 0;
+	LEVEL sum = 0;
+	for(; index < size - 1; ++index)
+	{
+		sum += weights[index];
+		if(value <= sum)
+			break;
+	}
+	return index;
+}
+
+/* Repeated squaring from the highest bit, as intPower in antsystem.cpp */
+double power(double base, int exponent)
+{
+	double result = 1;
+	for(int bit = 6; bit >= 0; --bit)
+	{
+		result = result * result;
+		if((exponent >> bit) & 1)
+			result = result * base;
+	}
+	return result;
+}
+
+double attraction(double phero, double heu)
+{
+#if ALPHA >= 0
+	double tau = power(phero, ALPHA);
+#else
+	double tau = pow(phero, A_PAR);
+#endif
+#if BETA >= 0
+	double eta = power(heu, BETA);
+#else
+	double eta = pow(heu, B_PAR);
+#endif
+	return tau * eta;
+}
+
+/* One ant per work-item, walking from its group's source until it reaches
+   the destination, a cycle or a dead end, or exceeds its group's limit.
+   The walk keeps the slots it moved along, at most one per node. */
+__kernel void construct(__global const int* starts, __global const int* degrees,
+		__global const int* targets, __global const double* weights,
+		__global const LEVEL* attracts, __global const double* rowSums,
+		__global const double* remaining, int guided, int nodes,
+		__global const int* sources, __global const double* limits, int ants,
+		int total, int end, ulong seedValue, ulong stream, int capacity,
+		__global uint* visited, __global int* slots, __global int* steps,
+		__global double* lengths, __global int* outcomes)
+{
+	int ant = get_global_id(0);
+	if(ant >= total)
+		return;
+	int words = (nodes + 31) / 32;
+	__global uint* seen = visited + (size_t)ant * words;
+	for(int word = 0; word < words; ++word)
+		seen[word] = 0;
+	__global int* trace = slots + (size_t)ant * capacity;
+
+	Xoshiro gen;
+	seedStream(&gen, seedValue, stream + ant);
+	int node = sources[ant / ants];
+	double limit = limits[ant / ants];
+	double length = 0;
+	int size = 0;
+	int outcome;
+	for(;;)
+	{
+		if(node < 0 || node >= nodes)
+		{
+			outcome = DEAD_END;
+			break;
+		}
+		if(seen[node >> 5] & (1u << (node & 31)))
+		{
+			outcome = CYCLE;
+			break;
+		}
+		if(length + (guided ? remaining[node] : 0) > limit)
+		{
+			outcome = PRUNED;
+			break;
+		}
+		if(node == end && size > 0)
+		{
+			outcome = ARRIVED;
+			break;
+		}
+		int first = starts[node];
+		int degree = degrees[node];
+		double rowSum = rowSums[node];
+		if(degree == 0 || rowSum <= 0)
+		{
+			outcome = DEAD_END;
+			break;
+		}
+		int index = spin(attracts + first, degree, (LEVEL)(uniformDraw(&gen) * rowSum));
+		seen[node >> 5] |= 1u << (node & 31);
+		length += weights[first + index];
+		trace[size++] = first + index;
+		node = targets[first + index];
+	}
+
+	steps[ant] = outcome == ARRIVED ? size : 0;
+	lengths[ant] = length;
+	outcomes[ant] = outcome;
+}
+
+/* Adds the fixed-point amount of every tour to the sums of its slots */
+__kernel void deposit(__global const int* slots, int capacity,
+		__global const int* steps, __global const ulong* amounts, int count,
+		__global ulong* sums)
+{
+	int tour = get_global_id(0);
+	if(tour >= count || !amounts[tour])
+		return;
+	__global const int* trace = slots + (size_t)tour * capacity;
+	for(int step = 0; step < steps[tour]; ++step)
+		atom_add(&sums[trace[step]], amounts[tour]);
+}
+
+/* Evaporates every level down to the smallest normal one, then adds the
+   slot's deposits */
+__kernel void evaporate(__global LEVEL* pheros, __global ulong* sums, double keep,
+		double scale, int size)
+{
+	int slot = get_global_id(0);
+	if(slot >= size)
+		return;
+	LEVEL phero = pheros[slot] * (LEVEL)keep;
+	if(phero < LEVEL_MIN)
+		phero = LEVEL_MIN;
+	ulong sum = sums[slot];
+	if(sum)
+	{
+		phero = (LEVEL)(phero + sum / scale);
+		sums[slot] = 0;
+	}
+	pheros[slot] = phero;
+}
+
+/* Recalculates the attractions of a node's row and their total */
+__kernel void refresh(__global const int* starts, __global const int* degrees,
+		__global const LEVEL* pheros, __global const double* heuristics,
+		__global LEVEL* attracts, __global double* rowSums, int nodes)
+{
+	int node = get_global_id(0);
+	if(node >= nodes)
+		return;
+	int first = starts[node];
+	double sum = 0;
+	for(int slot = first; slot < first + degrees[node]; ++slot)
+	{
+		LEVEL attract = (LEVEL)attraction(pheros[slot], heuristics[slot]);
+		attracts[slot] = attract;
+		sum += attract;
+	}
+	rowSums[node] = sum;
+}
+)";
+
+/**
+ * Returns the exponent the kernels raise to by repeated squaring, as
+ * the CPU does, or -1 for pow().
+ *
+ * @param exp The exponent
+ * @return int The integer exponent or -1
+ */
+static int intExponent(double exp)
+{
+	return exp >= 0 && exp <= 64 && exp == static_cast<int>(exp)
+			? static_cast<int>(exp) : -1;
+}
+
+/**
+ * Throws upon a failed call of the OpenCL API.
+ *
+ * @param status The call's status
+ * @param call The called function
+ */
+static void check(cl_int status, const char* call)
+{
+	if(status != CL_SUCCESS)
+		throw std::runtime_error(std::string("OpenCL: ") + call
+				+ " failed with error " + std::to_string(status));
+}
+
+// Context, kernels and buffers of the chosen device
+struct DeviceAntSystem::Device
+{
+	// A buffer that only grows, so colonies reuse the previous ones
+	struct Buffer
+	{
+		cl_mem mem = nullptr;
+		size_t size = 0;
+	};
+
+	Device() = default;
+	Device(const Device&) = delete;
+	Device& operator=(const Device&) = delete;
+	~Device();
+	void reserve(Buffer&, size_t);
+	void write(Buffer&, const void*, size_t);
+	void read(Buffer&, size_t, void*, size_t);
+	void arg(cl_kernel, cl_uint, const Buffer&);
+	template<class T>
+	void arg(cl_kernel, cl_uint, const T&);
+	void run(cl_kernel, size_t);
+
+	cl_context context = nullptr;
+	cl_command_queue queue = nullptr;
+	cl_program program = nullptr;
+	cl_kernel construct = nullptr;
+	cl_kernel deposit = nullptr;
+	cl_kernel evaporate = nullptr;
+	cl_kernel refresh = nullptr;
+	std::string name;
+	cl_ulong maxAlloc = 0;
+	cl_ulong globalMemory = 0;
+	// Topology, uploaded again after changes of its layout or weights
+	Buffer starts, degrees, targets, weights;
+	long int layout = -1;
+	long int weightVersion = -1;
+	// The colony's heuristics, levels and attractions
+	Buffer heuristics, pheros, attracts, rowSums, remaining, sums;
+	// The sources, their limits and the walks of an iteration's ants
+	Buffer sources, limits, visited, slots, steps, lengths, outcomes, amounts;
+	// The best tours so far, deposited once more by elitist ants
+	Buffer eliteSlots, eliteSteps, eliteAmounts;
+};
+
+/**
+ * Releases the device's objects.
+ */
+DeviceAntSystem::Device::~Device()
+{
+	for(Buffer* buffer : {&starts, &degrees, &targets, &weights, &heuristics,
+			&pheros, &attracts, &rowSums, &remaining, &sums, &sources, &limits,
+			&visited, &slots, &steps, &lengths, &outcomes, &amounts, &eliteSlots,
+			&eliteSteps, &eliteAmounts})
+		if(buffer->mem)
+			clReleaseMemObject(buffer->mem);
+	for(cl_kernel kernel : {construct, deposit, evaporate, refresh})
+		if(kernel)
+			clReleaseKernel(kernel);
+	if(program)
+		clReleaseProgram(program);
+	if(queue)
+		clReleaseCommandQueue(queue);
+	if(context)
+		clReleaseContext(context);
+}
+
+/**
+ * Grows a buffer to hold a number of bytes, discarding its contents.
+ *
+ * @param buffer The buffer
+ * @param bytes The number of bytes
+ */
+void DeviceAntSystem::Device::reserve(Buffer& buffer, size_t bytes)
+{
+	bytes = std::max<size_t>(bytes, 1);
+	if(buffer.size >= bytes)
+		return;
+	if(buffer.mem)
+		clReleaseMemObject(buffer.mem);
+	buffer.mem = nullptr;
+	buffer.size = 0;
+	cl_int status;
+	buffer.mem = clCreateBuffer(context, CL_MEM_READ_WRITE, bytes, nullptr, &status);
+	check(status, "clCreateBuffer");
+	buffer.size = bytes;
+}
+
+/**
+ * Copies host memory into a buffer, growing it when needed.
+ *
+ * @param buffer The buffer
+ * @param data The host memory
+ * @param bytes The number of bytes
+ */
+void DeviceAntSystem::Device::write(Buffer& buffer, const void* data, size_t bytes)
+{
+	reserve(buffer, bytes);
+	if(bytes > 0)
+		check(clEnqueueWriteBuffer(queue, buffer.mem, CL_TRUE, 0, bytes, data,
+				0, nullptr, nullptr), "clEnqueueWriteBuffer");
+}
+
+/**
+ * Copies a part of a buffer into host memory, once the queued kernels are done.
+ *
+ * @param buffer The buffer
+ * @param offset The part's first byte
+ * @param data The host memory
+ * @param bytes The number of bytes
+ */
+void DeviceAntSystem::Device::read(Buffer& buffer, size_t offset, void* data, size_t bytes)
+{
+	if(bytes > 0)
+		check(clEnqueueReadBuffer(queue, buffer.mem, CL_TRUE, offset, bytes, data,
+				0, nullptr, nullptr), "clEnqueueReadBuffer");
+}
+
+/**
+ * Sets a buffer argument of a kernel.
+ *
+ * @param kernel The kernel
+ * @param index The argument's position
+ * @param buffer The buffer
+ */
+void DeviceAntSystem::Device::arg(cl_kernel kernel, cl_uint index, const Buffer& buffer)
+{
+	check(clSetKernelArg(kernel, index, sizeof(cl_mem), &buffer.mem), "clSetKernelArg");
+}
+
+/**
+ * Sets a scalar argument of a kernel.
+ *
+ * @param kernel The kernel
+ * @param index The argument's position
+ * @param value The value, of the kernel's type
+ */
+template<class T>
+void DeviceAntSystem::Device::arg(cl_kernel kernel, cl_uint index, const T& value)
+{
+	check(clSetKernelArg(kernel, index, sizeof(T), &value), "clSetKernelArg");
+}
+
+/**
+ * Queues a kernel upon a number of work-items.
+ *
+ * @param kernel The kernel
+ * @param items The number of work-items
+ */
+void DeviceAntSystem::Device::run(cl_kernel kernel, size_t items)
+{
+	if(items > 0)
+		check(clEnqueueNDRangeKernel(queue, kernel, 1, nullptr, &items, nullptr,
+				0, nullptr, nullptr), "clEnqueueNDRangeKernel");
+}
+#else
+struct DeviceAntSystem::Device
+{
+};
+#endif
+
+/**
+ * Constructor initialising the topology from external file.
+ *
+ * @param filename A file containing the topology in JSON format or a snapshot
+ * @param ants Number of ants to unlease in each iteration
+ * @param iterations Number of iterations
+ */
+DeviceAntSystem::DeviceAntSystem(const std::string& filename, int ants, int iterations)
+		: AntSystem(filename, ants, iterations)
+{
+	open();
+}
+
+/**
+ * Constructor w/out initialising the topology.
+ *
+ * @param ants Number of ants to unlease in each iteration
+ * @param iterations Number of iterations
+ */
+DeviceAntSystem::DeviceAntSystem(int ants, int iterations) : AntSystem(ants, iterations)
+{
+	open();
+}
+
+/**
+ * Empty destructor.
+ */
+DeviceAntSystem::~DeviceAntSystem() { }
+
+/**
+ * Indicates whether the colonies run on a device.
+ *
+ * @return bool The indication of a device
+ */
+bool DeviceAntSystem::onDevice() const
+{
+	return device != nullptr;
+}
+
+/**
+ * Returns the name of the device, empty when the colonies run on the CPU.
+ *
+ * @return std::string The device's name
+ */
+std::string DeviceAntSystem::deviceName() const
+{
+#ifdef ACOPATH_OPENCL
+	if(device)
+		return device->name;
+#endif
+	return std::string();
+}
+
+/**
+ * Picks the first GPU, or else the first device of any kind, offering double
+ * precision and 64-bit atomics, and builds the kernels for it. Leaves the
+ * colonies upon the CPU when there is none or anything fails.
+ */
+void DeviceAntSystem::open()
+{
+#ifdef ACOPATH_OPENCL
+	cl_uint count = 0;
+	if(clGetPlatformIDs(0, nullptr, &count) != CL_SUCCESS || count == 0)
+		return;
+	std::vector<cl_platform_id> platforms(count);
+	if(clGetPlatformIDs(count, platforms.data(), nullptr) != CL_SUCCESS)
+		return;
+
+	auto capable = [](cl_device_id id)
+	{
+		size_t size = 0;
+		if(clGetDeviceInfo(id, CL_DEVICE_EXTENSIONS, 0, nullptr, &size) != CL_SUCCESS)
+			return false;
+		std::string extensions(size, '\0');
+		if(clGetDeviceInfo(id, CL_DEVICE_EXTENSIONS, size, extensions.data(),
+				nullptr) != CL_SUCCESS)
+			return false;
+		return extensions.find("cl_khr_fp64") != std::string::npos
+				&& extensions.find("cl_khr_int64_base_atomics") != std::string::npos;
+	};
+	cl_device_id chosen = nullptr;
+	const cl_device_type types[] = {CL_DEVICE_TYPE_GPU, CL_DEVICE_TYPE_ALL};
+	for(cl_device_type type : types)
+		for(cl_platform_id platform : platforms)
+		{
+			cl_uint devices = 0;
+			if(chosen || clGetDeviceIDs(platform, type, 0, nullptr, &devices)
+					!= CL_SUCCESS || devices == 0)
+				continue;
+			std::vector<cl_device_id> ids(devices);
+			if(clGetDeviceIDs(platform, type, devices, ids.data(), nullptr) != CL_SUCCESS)
+				continue;
+			for(cl_device_id id : ids)
+				if(!chosen && capable(id))
+					chosen = id;
+		}
+	if(!chosen)
+		return;
+
+	auto opened = std::make_unique<Device>();
+	try
+	{
+		Device& d = *opened;
+		cl_int status;
+		d.context = clCreateContext(nullptr, 1, &chosen, nullptr, nullptr, &status);
+		check(status, "clCreateContext");
+		d.queue = clCreateCommandQueue(d.context, chosen, 0, &status);
+		check(status, "clCreateCommandQueue");
+		d.program = clCreateProgramWithSource(d.context, 1, &KERNELS, nullptr, &status);
+		check(status, "clCreateProgramWithSource");
+
+		std::ostringstream options;
+		options.precision(17);
+		options << "-D LEVEL=" << (sizeof(Level) == sizeof(float) ? "float" : "double")
+				<< " -D LEVEL_MIN=" << (sizeof(Level) == sizeof(float) ? "FLT_MIN" : "DBL_MIN")
+				<< " -D ALPHA=" << intExponent(A_PAR) << " -D BETA=" << intExponent(B_PAR)
+				<< " -D A_PAR=" << A_PAR << " -D B_PAR=" << B_PAR;
+		if(clBuildProgram(d.program, 1, &chosen, options.str().c_str(), nullptr,
+				nullptr) != CL_SUCCESS)
+		{
+			size_t size = 0;
+			clGetProgramBuildInfo(d.program, chosen, CL_PROGRAM_BUILD_LOG, 0, nullptr, &size);
+			std::string log(size, '\0');
+			clGetProgramBuildInfo(d.program, chosen, CL_PROGRAM_BUILD_LOG, size,
+					log.data(), nullptr);
+			throw std::runtime_error("OpenCL: building the kernels failed\n" + log);
+		}
+		for(auto [kernel, name] : {std::pair(&d.construct, "construct"),
+				std::pair(&d.deposit, "deposit"), std::pair(&d.evaporate, "evaporate"),
+				std::pair(&d.refresh, "refresh")})
+		{
+			*kernel = clCreateKernel(d.program, name, &status);
+			check(status, "clCreateKernel");
+		}
+
+		size_t size = 0;
+		check(clGetDeviceInfo(chosen, CL_DEVICE_NAME, 0, nullptr, &size), "clGetDeviceInfo");
+		d.name.resize(size);
+		check(clGetDeviceInfo(chosen, CL_DEVICE_NAME, size, d.name.data(), nullptr),
+				"clGetDeviceInfo");
+		d.name.resize(std::strlen(d.name.c_str()));
+		check(clGetDeviceInfo(chosen, CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(cl_ulong),
+				&d.maxAlloc, nullptr), "clGetDeviceInfo");
+		check(clGetDeviceInfo(chosen, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(cl_ulong),
+				&d.globalMemory, nullptr), "clGetDeviceInfo");
+	}
+	catch(const std::runtime_error& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return;
+	}
+	device = std::move(opened);
+#endif
+}
+
+/**
+ * Runs one colony towards a destination on the device when its rule and
+ * walks allow, or else upon the CPU. A device failing in the middle of a
+ * colony is given up for good and the colony runs again upon the CPU.
+ *
+ * @param sources Paths' starting points
+ * @param end Paths' end point
+ * @param hint Supplier of known paths from the sources, if any
+ * @return std::vector<Result> The outcome for every source
+ */
+std::vector<AntSystem::Result> DeviceAntSystem::colony(const std::vector<int>& sources,
+		int end, const Hint& hint)
+{
+#ifdef ACOPATH_OPENCL
+	bool supported = (strategy.rule == Rule::ANT_SYSTEM || strategy.rule == Rule::ELITIST)
+			&& !strategy.bidirectional && !(migration && migrationInterval > 0);
+	if(device && supported && fits(ants * static_cast<int>(sources.size()),
+			static_cast<int>(graph->starts.size())))
+	{
+		std::uint64_t drawn = streams;
+		Stats counted = statistics;
+		try
+		{
+			return deviceColony(sources, end, hint);
+		}
+		catch(const std::runtime_error& e)
+		{
+			std::cerr << e.what() << ", going on upon the CPU" << std::endl;
+			device.reset();
+			guided = false;
+			streams = drawn;
+			statistics = counted;
+		}
+	}
+#endif
+	return AntSystem::colony(sources, end, hint);
+}
+
+#ifdef ACOPATH_OPENCL
+/**
+ * Checks that the walks of a colony's ants and the topology fit the
+ * device's memory.
+ *
+ * @param total The number of ants of an iteration
+ * @param nodes The number of nodes
+ * @return bool The indication of fitting
+ */
+bool DeviceAntSystem::fits(int total, int nodes) const
+{
+	const Graph& g = *graph;
+	std::uint64_t slots = static_cast<std::uint64_t>(total) * std::max(nodes, 1) * sizeof(int);
+	std::uint64_t visited = static_cast<std::uint64_t>(total) * ((nodes + 31) / 32)
+			* sizeof(cl_uint);
+	std::uint64_t topology = g.targets.size() * (sizeof(int) + 3 * sizeof(double)
+			+ 2 * sizeof(Level)) + g.starts.size() * (2 * sizeof(int) + 2 * sizeof(double));
+
+	return total > 0 && slots <= device->maxAlloc && visited <= device->maxAlloc
+			&& slots + visited + topology <= device->globalMemory;
+}
+
+/**
+ * Uploads the topology after changes of its layout or weights, and the
+ * heuristics, pheromone levels and attractions of the colony about to run.
+ */
+void DeviceAntSystem::upload()
+{
+	Device& d = *device;
+	const Graph& g = *graph;
+	if(d.layout != layout || d.weightVersion != weightVersion)
+	{
+		d.layout = d.weightVersion = -1;
+		d.write(d.starts, g.starts.data(), g.starts.size() * sizeof(int));
+		d.write(d.degrees, g.degrees.data(), g.degrees.size() * sizeof(int));
+		d.write(d.targets, g.targets.data(), g.targets.size() * sizeof(int));
+		d.write(d.weights, g.weights.data(), g.weights.size() * sizeof(double));
+		d.layout = layout;
+		d.weightVersion = weightVersion;
+	}
+
+	const Column<double>& heuristics = guided ? guidance : g.heuristics;
+	d.write(d.heuristics, heuristics.data(), heuristics.size() * sizeof(double));
+	d.write(d.pheros, pheros.data(), pheros.size() * sizeof(Level));
+	d.write(d.attracts, attracts.data(), attracts.size() * sizeof(Level));
+	d.write(d.rowSums, rowSums.data(), rowSums.size() * sizeof(double));
+	if(guided)
+		d.write(d.remaining, remaining.data(), remaining.size() * sizeof(double));
+	else
+		d.reserve(d.remaining, sizeof(double));
+	std::vector<cl_ulong> zeros(pheros.size(), 0);
+	d.write(d.sums, zeros.data(), zeros.size() * sizeof(cl_ulong));
+}
+
+/**
+ * Runs one colony towards a destination on the device, with an equal number
+ * of ants released from every source in each iteration, until one of the
+ * stopping criteria is met. The pheromone levels return to the host once
+ * the colony stops.
+ *
+ * @param sources Paths' starting points
+ * @param end Paths' end point
+ * @param hint Supplier of known paths from the sources, if any
+ * @return std::vector<Result> The outcome for every source
+ */
+std::vector<AntSystem::Result> DeviceAntSystem::deviceColony(
+		const std::vector<int>& sources, int end, const Hint& hint)
+{
+	auto began = std::chrono::steady_clock::now();
+	Device& d = *device;
+	const Graph& g = *graph;
+	int groups = static_cast<int>(sources.size());
+	std::vector<Result> results(groups);
+	std::vector<double> shortest(groups, std::numeric_limits<double>::max());
+	StopReason reason = StopReason::ITERATIONS;
+	// For the predefined number of iterations, or less when warm-started
+	int budget = iterations;
+	const Table* table = tableCapacity > 0 ? restoreTable(end) : nullptr;
+	if(table)
+	{
+		budget = warmIterations;
+		for(int s = 0; s < groups; ++s)
+		{
+			auto it = table->bests.find(sources[s]);
+			if(it == table->bests.end())
+				continue;
+			results[s].path = it->second;
+			shortest[s] = results[s].length = calcTourLength(results[s].path);
+		}
+	}
+	if(hint)
+		layHints(sources, end, hint);
+	if(criteria.maxIterations > 0)
+		budget = std::min(budget, criteria.maxIterations);
+
+	guide(sources, end);
+	refreshAttractions();
+	if(instrumented)
+	{
+		++statistics.colonies;
+		statistics.trajectory.clear();
+	}
+	upload();
+	int nodes = static_cast<int>(g.starts.size());
+	int size = static_cast<int>(pheros.size());
+	int total = ants * groups;
+	int capacity = std::max(nodes, 1);
+	d.write(d.sources, sources.data(), groups * sizeof(int));
+	d.reserve(d.limits, groups * sizeof(double));
+	d.reserve(d.visited, static_cast<size_t>(total) * ((nodes + 31) / 32) * sizeof(cl_uint));
+	d.reserve(d.slots, static_cast<size_t>(total) * capacity * sizeof(int));
+	d.reserve(d.steps, total * sizeof(int));
+	d.reserve(d.lengths, total * sizeof(double));
+	d.reserve(d.outcomes, total * sizeof(int));
+	d.reserve(d.amounts, total * sizeof(cl_ulong));
+
+	cl_int guidedArg = guided;
+	cl_ulong seedArg = seedValue;
+	d.arg(d.construct, 0, d.starts);
+	d.arg(d.construct, 1, d.degrees);
+	d.arg(d.construct, 2, d.targets);
+	d.arg(d.construct, 3, d.weights);
+	d.arg(d.construct, 4, d.attracts);
+	d.arg(d.construct, 5, d.rowSums);
+	d.arg(d.construct, 6, d.remaining);
+	d.arg(d.construct, 7, guidedArg);
+	d.arg(d.construct, 8, nodes);
+	d.arg(d.construct, 9, d.sources);
+	d.arg(d.construct, 10, d.limits);
+	d.arg(d.construct, 11, ants);
+	d.arg(d.construct, 12, total);
+	d.arg(d.construct, 13, end);
+	d.arg(d.construct, 14, seedArg);
+	d.arg(d.construct, 16, capacity);
+	d.arg(d.construct, 17, d.visited);
+	d.arg(d.construct, 18, d.slots);
+	d.arg(d.construct, 19, d.steps);
+	d.arg(d.construct, 20, d.lengths);
+	d.arg(d.construct, 21, d.outcomes);
+	d.arg(d.evaporate, 0, d.pheros);
+	d.arg(d.evaporate, 1, d.sums);
+	d.arg(d.evaporate, 2, 1 - strategy.evaporation);
+	d.arg(d.evaporate, 4, size);
+	d.arg(d.refresh, 0, d.starts);
+	d.arg(d.refresh, 1, d.degrees);
+	d.arg(d.refresh, 2, d.pheros);
+	d.arg(d.refresh, 3, d.heuristics);
+	d.arg(d.refresh, 4, d.attracts);
+	d.arg(d.refresh, 5, d.rowSums);
+	d.arg(d.refresh, 6, nodes);
+
+	std::vector<int> steps(total), outcomes(total);
+	std::vector<double> lengths(total), deposits(total), limits(groups);
+	std::vector<cl_ulong> amounts(total);
+	std::vector<int> best(groups), trace;
+	long arrived = 0, cycles = 0, deadEnds = 0, pruned = 0;
+	double tourLengths = 0;
+	int stagnant = 0;
+	int i = 0;
+	while(i < budget)
+	{
+		auto constructStart = instrumented ? std::chrono::steady_clock::now()
+				: std::chrono::steady_clock::time_point();
+		cl_ulong stream = streams;
+		streams += total;
+		for(int s = 0; s < groups; ++s)
+			limits[s] = strategy.pruning > 0 && shortest[s] < std::numeric_limits<double>::max()
+					? shortest[s] * strategy.pruning : std::numeric_limits<double>::infinity();
+		d.write(d.limits, limits.data(), groups * sizeof(double));
+		d.arg(d.construct, 15, stream);
+		d.run(d.construct, total);
+		d.read(d.outcomes, 0, outcomes.data(), total * sizeof(int));
+		d.read(d.steps, 0, steps.data(), total * sizeof(int));
+		d.read(d.lengths, 0, lengths.data(), total * sizeof(double));
+
+		// The first of the shortest tours of every source, as upon the CPU
+		std::fill(best.begin(), best.end(), -1);
+		for(int j = 0; j < total; ++j)
+		{
+			int s = j / ants;
+			switch(outcomes[j])
+			{
+			case ARRIVED:
+				++arrived;
+				tourLengths += lengths[j];
+				if(lengths[j] > 0 && (best[s] == -1 || lengths[j] < lengths[best[s]]))
+					best[s] = j;
+				break;
+			case CYCLE:
+				++cycles;
+				break;
+			case DEAD_END:
+				++deadEnds;
+				break;
+			case PRUNED:
+				++pruned;
+				break;
+			}
+		}
+		auto updateStart = instrumented ? std::chrono::steady_clock::now()
+				: std::chrono::steady_clock::time_point();
+		if(instrumented)
+			statistics.constructTime += updateStart - constructStart;
+
+		++stagnant;
+		for(int s = 0; s < groups; ++s)
+			if(best[s] != -1 && lengths[best[s]] < shortest[s])
+			{
+				int j = best[s];
+				trace.resize(steps[j]);
+				d.read(d.slots, static_cast<size_t>(j) * capacity * sizeof(int),
+						trace.data(), steps[j] * sizeof(int));
+				shortest[s] = results[s].length = lengths[j];
+				results[s].path.assign(1, sources[s]);
+				for(int slot : trace)
+					results[s].path.push_back(g.targets[slot]);
+				stagnant = 0;
+			}
+
+		// Every tour deposits, and elitist ants the best tours so far once
+		// more, in fixed point out of a power of two above their total
+		double bound = 0;
+		for(int j = 0; j < total; ++j)
+		{
+			deposits[j] = steps[j] > 0 && lengths[j] > 0 ? diffPheromone(lengths[j]) : 0;
+			bound += deposits[j];
+		}
+		std::vector<int> eliteSlots, eliteSteps;
+		std::vector<double> eliteDeposits;
+		int eliteCapacity = 0;
+		if(strategy.rule == Rule::ELITIST)
+			for(auto& result : results)
+				if(result.path.size() > 1)
+				{
+					eliteDeposits.push_back(strategy.elitism * diffPheromone(result.length));
+					bound += eliteDeposits.back();
+					eliteCapacity = std::max(eliteCapacity, (int)result.path.size() - 1);
+				}
+		int exponent = 0;
+		std::frexp(bound, &exponent);
+		double scale = std::ldexp(1.0, 62 - exponent);
+		for(int j = 0; j < total; ++j)
+			amounts[j] = static_cast<cl_ulong>(deposits[j] * scale);
+		if(bound > 0)
+		{
+			d.write(d.amounts, amounts.data(), total * sizeof(cl_ulong));
+			d.arg(d.deposit, 0, d.slots);
+			d.arg(d.deposit, 1, capacity);
+			d.arg(d.deposit, 2, d.steps);
+			d.arg(d.deposit, 3, d.amounts);
+			d.arg(d.deposit, 4, total);
+			d.arg(d.deposit, 5, d.sums);
+			d.run(d.deposit, total);
+		}
+		if(!eliteDeposits.empty())
+		{
+			std::vector<cl_ulong> eliteAmounts;
+			for(auto& result : results)
+			{
+				if(result.path.size() <= 1)
+					continue;
+				int first = (int)eliteSlots.size();
+				int count = 0;
+				eliteSlots.resize(first + eliteCapacity, 0);
+				for(unsigned int k = 0; k + 1 < result.path.size(); ++k)
+				{
+					int slot = findSlot(result.path[k], result.path[k + 1]);
+					if(slot != -1)
+						eliteSlots[first + count++] = slot;
+				}
+				eliteSteps.push_back(count);
+				eliteAmounts.push_back(static_cast<cl_ulong>(
+						eliteDeposits[eliteAmounts.size()] * scale));
+			}
+			int count = (int)eliteSteps.size();
+			d.write(d.eliteSlots, eliteSlots.data(), eliteSlots.size() * sizeof(int));
+			d.write(d.eliteSteps, eliteSteps.data(), count * sizeof(int));
+			d.write(d.eliteAmounts, eliteAmounts.data(), count * sizeof(cl_ulong));
+			d.arg(d.deposit, 0, d.eliteSlots);
+			d.arg(d.deposit, 1, eliteCapacity);
+			d.arg(d.deposit, 2, d.eliteSteps);
+			d.arg(d.deposit, 3, d.eliteAmounts);
+			d.arg(d.deposit, 4, count);
+			d.arg(d.deposit, 5, d.sums);
+			d.run(d.deposit, count);
+		}
+		d.arg(d.evaporate, 3, bound > 0 ? scale : 1.0);
+		d.run(d.evaporate, size);
+		d.run(d.refresh, nodes);
+		check(clFinish(d.queue), "clFinish");
+		++i;
+		if(instrumented)
+		{
+			statistics.updateTime += std::chrono::steady_clock::now() - updateStart;
+			statistics.trajectory.push_back(*std::min_element(shortest.begin(),
+					shortest.end()));
+		}
+
+		if(criteria.stagnation > 0 && stagnant >= criteria.stagnation)
+		{
+			reason = StopReason::STAGNATION;
+			break;
+		}
+		if(criteria.entropy > 0 && converged(results))
+		{
+			reason = StopReason::ENTROPY;
+			break;
+		}
+		if(criteria.deadline.count() > 0
+				&& std::chrono::steady_clock::now() - began >= criteria.deadline)
+		{
+			reason = StopReason::DEADLINE;
+			break;
+		}
+	}
+
+	// The levels return to the host, which derives the attractions anew
+	d.read(d.pheros, 0, pheros.data(), pheros.size() * sizeof(Level));
+	refreshAttractions();
+	guided = false;
+	if(instrumented)
+	{
+		statistics.iterations += i;
+		statistics.arrived += arrived;
+		statistics.cycles += cycles;
+		statistics.deadEnds += deadEnds;
+		statistics.pruned += pruned;
+		statistics.tourLengths += tourLengths;
+	}
+	if(tableCapacity > 0)
+		storeTable(end, results);
+	checkpoint();
+
+	for(int s = 0; s < groups; ++s)
+	{
+		results[s].length = results[s].path.empty() ? 0 : shortest[s];
+		results[s].iterations = i;
+		results[s].reason = reason;
+	}
+	return results;
+}
+#endif
@@ -0,0 +1,65 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef DEVICEANTSYSTEM_H
+#define DEVICEANTSYSTEM_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "antsystem.h"
+
+/**
+ * Ant System whose colonies run on an OpenCL device, e.g., a GPU, when 
+ * built with ACOPATH_OPENCL. Every ant walks in a work-item of its own over 
+ * a device-resident copy of the adjacency, with the same numbered random 
+ * stream as upon the CPU, while evaporation, deposits and attractions are 
+ * kernels between the iterations. Deposits are summed with 64-bit integer 
+ * atomics in fixed point, so a seed still gives the same paths. Colonies 
+ * of other rules, bidirectional or migrating ones and colonies whose walks 
+ * do not fit the device's memory run upon the CPU, as do all of them 
+ * without a device offering double precision and 64-bit atomics.
+ */
+class DeviceAntSystem : public AntSystem
+{
+public:
+	DeviceAntSystem(const std::string&, int = 0, int = 0);
+	DeviceAntSystem(int = 0, int = 0);
+	virtual ~DeviceAntSystem();
+	bool onDevice() const;
+	std::string deviceName() const;
+
+private:
+	struct Device;
+
+	void open();
+	bool fits(int, int) const;
+	virtual std::vector<Result> colony(const std::vector<int>&, int, const Hint& = nullptr);
+	std::vector<Result> deviceColony(const std::vector<int>&, int, const Hint&);
+	void upload();
+	std::unique_ptr<Device> device;
+};
+
+#endif // DEVICEANTSYSTEM_H
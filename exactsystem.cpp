@@ -0,0 +1,425 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <limits>
+#include "exactsystem.h"
+
+/**
+ * Constructor initialising the topology from external file.
+ *
+ * @param filename A file containing the topology in JSON format or a snapshot
+ */
+ExactSystem::ExactSystem(const std::string& filename) : ExactSystem()
+{
+	try
+	{
+		initTopo(filename);
+	}
+	catch(std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+	}
+}
+
+/**
+ * Constructor searching the topology of a colony, which reflects every 
+ * change made through the colony. The edges cannot be changed through 
+ * this instance.
+ *
+ * @param colony The colony, which must outlive this instance
+ */
+ExactSystem::ExactSystem(const AntSystem& colony) : ExactSystem()
+{
+	this->colony = &colony;
+}
+
+/**
+ * Constructor w/out initialising the topology.
+ */
+ExactSystem::ExactSystem() : colony(nullptr), nodes(0), built(false), epoch(0) { }
+
+/**
+ * Empty destructor.
+ */
+ExactSystem::~ExactSystem() { }
+
+/**
+ * Finds the shortest path from a source node to a destination.
+ *
+ * @param start Path's starting point
+ * @param end Path's end point
+ * @return std::vector<int> The shortest path, empty when there is none
+ */
+std::vector<int> ExactSystem::path(int start, int end)
+{
+	return query(start, end).path;
+}
+
+/**
+ * Finds the shortest path from a source node to a destination, settling 
+ * nodes in order of their distance plus the heuristic's bound, until the 
+ * destination is settled.
+ *
+ * @param start Path's starting point
+ * @param end Path's end point
+ * @return Result The shortest path and its length, empty and 0 when none
+ */
+ExactSystem::Result ExactSystem::query(int start, int end)
+{
+	if(!colony && !built)
+		build();
+	const Adjacency a = adjacency();
+	Result result{std::vector<int>(), 0};
+	if(start == end || start < 0 || end < 0 || start >= a.nodes || end >= a.nodes)
+		return result;
+
+	// A new epoch resets the state of every node at once
+	if((int)stamps.size() < a.nodes)
+	{
+		stamps.resize(a.nodes, 0);
+		dists.resize(a.nodes);
+		parents.resize(a.nodes);
+		positions.resize(a.nodes);
+		keys.resize(a.nodes);
+	}
+	if(++epoch == 0)
+	{
+		std::fill(stamps.begin(), stamps.end(), 0);
+		epoch = 1;
+	}
+	heap.clear();
+	stamps[start] = epoch;
+	dists[start] = 0;
+	parents[start] = -1;
+	positions[start] = -2;
+	push(start, heuristic ? heuristic(start, end) : 0);
+	while(!heap.empty())
+	{
+		int node = pop();
+		if(node == end)
+			break;
+		for(int slot = a.starts[node]; slot < a.starts[node] + a.degrees[node]; ++slot)
+		{
+			int target = a.targets[slot];
+			double dist = dists[node] + a.weights[slot];
+			if(stamps[target] != epoch)
+			{
+				stamps[target] = epoch;
+				positions[target] = -2;
+			}
+			else if(positions[target] == -1 || dist >= dists[target])
+				continue;
+			dists[target] = dist;
+			parents[target] = node;
+			push(target, dist + (heuristic ? heuristic(target, end) : 0));
+		}
+	}
+	if(stamps[end] != epoch || positions[end] != -1)
+		return result;
+
+	for(int node = end; node != -1; node = parents[node])
+		result.path.push_back(node);
+	std::reverse(result.path.begin(), result.path.end());
+	result.length = dists[end];
+	return result;
+}
+
+/**
+ * Removes all edges.
+ */
+void ExactSystem::clear()
+{
+	owned();
+	edges.clear();
+	nodes = 0;
+	built = false;
+}
+
+/**
+ * Inserts an edge, after which the adjacency is rebuilt by the next query.
+ * Edges repeating an earlier one are dropped then, unless the adjacency is 
+ * built and rejects them at once.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @param weight Weight for the edge
+ */
+void ExactSystem::insertEdge(int src, int dest, double weight)
+{
+	owned();
+	if(built && findSlot(src, dest) != -1)
+		throw std::invalid_argument("edge " + std::to_string(src) + " -> " 
+				+ std::to_string(dest) + " exists already");
+	AdaptiveSystem::insertEdge(src, dest, weight);
+	nodes = std::max(nodes, std::max(src, dest) + 1);
+	built = false;
+}
+
+/**
+ * Removes an edge, after which the adjacency is rebuilt by the next query.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @return bool The indication of an existing edge being removed
+ */
+bool ExactSystem::removeEdge(int src, int dest)
+{
+	owned();
+	if(!AdaptiveSystem::removeEdge(src, dest))
+		return false;
+
+	built = false;
+	return true;
+}
+
+/**
+ * Updates the weight of an edge in place.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @param weight New weight for the edge
+ * @return bool The indication of an existing edge being updated
+ */
+bool ExactSystem::updateEdge(int src, int dest, double weight)
+{
+	owned();
+	if(!built)
+		return AdaptiveSystem::updateEdge(src, dest, weight);
+
+	int slot = findSlot(src, dest);
+	if(slot == -1)
+		return false;
+
+	edges[edgeIds[slot]].weight = weight;
+	weights[slot] = weight;
+	return true;
+}
+
+/**
+ * Writes the topology as a binary snapshot.
+ * 
+ * @param filename The snapshot file
+ */
+void ExactSystem::saveSnapshot(const std::string& filename)
+{
+	owned();
+	AdaptiveSystem::saveSnapshot(filename);
+}
+
+/**
+ * Sets the lower bound of the remaining distance, or none for Dijkstra's 
+ * algorithm.
+ *
+ * @param heuristic The bound
+ */
+void ExactSystem::setHeuristic(const Heuristic& heuristic)
+{
+	this->heuristic = heuristic;
+}
+
+/**
+ * Hint about the number of nodes before edges are inserted.
+ *
+ * @param nodes Expected number of nodes
+ */
+void ExactSystem::reserveNodes(int nodes)
+{
+	this->nodes = std::max(this->nodes, nodes);
+}
+
+/**
+ * Returns the number of nodes, including the ones without edges.
+ *
+ * @return int Number of nodes
+ */
+int ExactSystem::nodeCount() const
+{
+	if(colony)
+		return (int)colony->graph->starts.size();
+	return std::max(nodes, AdaptiveSystem::nodeCount());
+}
+
+/**
+ * Returns the rows of the colony's topology, or of the owned edges.
+ *
+ * @return Adjacency The rows
+ */
+ExactSystem::Adjacency ExactSystem::adjacency() const
+{
+	if(colony)
+	{
+		const AntSystem::Graph& g = *colony->graph;
+		return {g.starts.data(), g.degrees.data(), g.targets.data(), g.weights.data(), 
+				(int)g.starts.size()};
+	}
+
+	return {starts.data(), degrees.data(), targets.data(), weights.data(), nodes};
+}
+
+/**
+ * Rejects changes to the edges of a colony's topology.
+ */
+void ExactSystem::owned() const
+{
+	if(colony)
+		throw std::logic_error("the topology belongs to the colony");
+}
+
+/**
+ * Builds the adjacency by sorting the edges by starting node, after the 
+ * repeated ones are dropped.
+ */
+void ExactSystem::build()
+{
+	dropDuplicates();
+	for(auto& edge : edges)
+		nodes = std::max(nodes, std::max(edge.edgeStart, edge.edgeEnd) + 1);
+
+	starts.assign(nodes + 1, 0);
+	for(auto& edge : edges)
+		++starts[edge.edgeStart + 1];
+	for(int node = 0; node < nodes; ++node)
+		starts[node + 1] += starts[node];
+	degrees.resize(nodes);
+	for(int node = 0; node < nodes; ++node)
+		degrees[node] = starts[node + 1] - starts[node];
+	std::vector<int> next(starts.begin(), starts.end() - 1);
+	targets.resize(edges.size());
+	weights.resize(edges.size());
+	edgeIds.resize(edges.size());
+	for(auto& edge : edges)
+	{
+		int slot = next[edge.edgeStart]++;
+		targets[slot] = edge.edgeEnd;
+		weights[slot] = edge.weight;
+		edgeIds[slot] = static_cast<int>(edge.id);
+	}
+	built = true;
+}
+
+/**
+ * Inserts a node into the heap, or moves it up when it is there already 
+ * and its key decreased.
+ *
+ * @param node The node
+ * @param key The node's key
+ */
+void ExactSystem::push(int node, double key)
+{
+	keys[node] = key;
+	if(positions[node] < 0)
+	{
+		positions[node] = static_cast<int>(heap.size());
+		heap.push_back(node);
+	}
+	siftUp(positions[node]);
+}
+
+/**
+ * Removes the node with the smallest key from the heap, marking it settled.
+ *
+ * @return int The node
+ */
+int ExactSystem::pop()
+{
+	int top = heap.front();
+	positions[top] = -1;
+	int last = heap.back();
+	heap.pop_back();
+	if(!heap.empty())
+	{
+		heap.front() = last;
+		positions[last] = 0;
+		siftDown(0);
+	}
+
+	return top;
+}
+
+/**
+ * Moves a heap entry up until its parent's key is not larger.
+ *
+ * @param position The entry's position
+ */
+void ExactSystem::siftUp(int position)
+{
+	int node = heap[position];
+	while(position > 0)
+	{
+		int parent = (position - 1) / ARITY;
+		if(keys[heap[parent]] <= keys[node])
+			break;
+		heap[position] = heap[parent];
+		positions[heap[position]] = position;
+		position = parent;
+	}
+	heap[position] = node;
+	positions[node] = position;
+}
+
+/**
+ * Moves a heap entry down until no child's key is smaller.
+ *
+ * @param position The entry's position
+ */
+void ExactSystem::siftDown(int position)
+{
+	int node = heap[position];
+	int size = static_cast<int>(heap.size());
+	while(true)
+	{
+		int first = position * ARITY + 1;
+		if(first >= size)
+			break;
+		int child = first;
+		for(int other = first + 1; other < first + ARITY && other < size; ++other)
+			if(keys[heap[other]] < keys[heap[child]])
+				child = other;
+		if(keys[heap[child]] >= keys[node])
+			break;
+		heap[position] = heap[child];
+		positions[heap[position]] = position;
+		position = child;
+	}
+	heap[position] = node;
+	positions[node] = position;
+}
+
+/**
+ * Returns the slot of an edge.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @return int The slot or -1 when no such edge exists
+ */
+int ExactSystem::findSlot(int src, int dest) const
+{
+	if(src < 0 || src >= nodes)
+		return -1;
+	for(int slot = starts[src]; slot < starts[src + 1]; ++slot)
+		if(targets[slot] == dest)
+			return slot;
+
+	return -1;
+}
@@ -0,0 +1,119 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef EXACTSYSTEM_H
+#define EXACTSYSTEM_H
+
+#include <functional>
+#include <iostream>
+#include <vector>
+#include "antsystem.h"
+
+/**
+ * Exact shortest paths by Dijkstra's algorithm upon a compressed-sparse-row 
+ * adjacency, with a d-ary heap whose shallow levels keep decrease-key cheap. 
+ * Given a lower bound of the remaining distance, e.g., the straight-line 
+ * one, the search turns into A*. Weights must not be negative. Like the 
+ * colonies, it keeps the first of the edges repeating a pair of nodes. It 
+ * can also search the topology of a colony in place, which then stays the 
+ * only owner of the edges.
+ */
+class ExactSystem : public AdaptiveSystem
+{
+public:
+	// Lower bound of the distance from the first node to the second one, 
+	// which must be consistent, i.e., never exceed an edge's weight plus 
+	// the bound from the edge's end
+	typedef std::function<double(int, int)> Heuristic;
+
+	struct Result
+	{
+		std::vector<int> path;
+		double length;
+	};
+
+	static const int ARITY = 4;
+	ExactSystem(const std::string&);
+	explicit ExactSystem(const AntSystem&);
+	ExactSystem();
+	virtual ~ExactSystem();
+	virtual std::vector<int> path(int, int);
+	Result query(int, int);
+	virtual void clear();
+	virtual void insertEdge(int, int, double) noexcept(false);
+	virtual bool removeEdge(int, int);
+	virtual bool updateEdge(int, int, double);
+	virtual void saveSnapshot(const std::string&) noexcept(false);
+	void setHeuristic(const Heuristic&);
+
+protected:
+	virtual void reserveNodes(int);
+	virtual int nodeCount() const;
+
+private:
+	// Rows of the searched adjacency, where the outgoing edges of node n 
+	// occupy the slots [starts[n], starts[n] + degrees[n])
+	struct Adjacency
+	{
+		const int* starts;
+		const int* degrees;
+		const int* targets;
+		const double* weights;
+		int nodes;
+	};
+
+	Adjacency adjacency() const;
+	void owned() const noexcept(false);
+	void build();
+	void push(int, double);
+	int pop();
+	void siftUp(int);
+	void siftDown(int);
+	int findSlot(int, int) const;
+	// The colony whose topology is searched, or none when the edges are 
+	// owned
+	const AntSystem* colony;
+	int nodes;
+	// Set after the adjacency is built and cleared by structural changes
+	bool built;
+	// Compressed-sparse-row adjacency of the owned edges, where the outgoing 
+	// edges of node n occupy the slots [starts[n], starts[n + 1])
+	std::vector<int> starts;
+	std::vector<int> degrees;
+	std::vector<int> targets;
+	std::vector<double> weights;
+	std::vector<int> edgeIds;
+	// Search state of every node, valid when stamped with the current epoch
+	std::vector<unsigned int> stamps;
+	unsigned int epoch;
+	std::vector<double> dists;
+	std::vector<int> parents;
+	// Heap position of every node, -1 once settled and -2 before queued
+	std::vector<int> positions;
+	std::vector<double> keys;
+	std::vector<int> heap;
+	Heuristic heuristic;
+};
+
+#endif // EXACTSYSTEM_H
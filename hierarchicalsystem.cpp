@@ -0,0 +1,605 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "hierarchicalsystem.h"
+
+/**
+ * Constructor initialising the topology from external file. The partitions
+ * are built by the first query.
+ *
+ * @param filename A file containing the topology in JSON format or a snapshot
+ * @param partSize Maximum number of nodes of a grown partition
+ * @param ants Number of ants to unlease in each iteration of both levels
+ * @param iterations Number of iterations of both levels
+ */
+HierarchicalSystem::HierarchicalSystem(const std::string& filename, int partSize,
+		int ants, int iterations) : HierarchicalSystem(partSize, ants, iterations)
+{
+	try
+	{
+		initTopo(filename);
+	}
+	catch(std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+	}
+}
+
+/**
+ * Constructor w/out initialising the topology.
+ *
+ * @param partSize Maximum number of nodes of a grown partition
+ * @param ants Number of ants to unlease in each iteration of both levels
+ * @param iterations Number of iterations of both levels
+ */
+HierarchicalSystem::HierarchicalSystem(int partSize, int ants, int iterations)
+		: partSize(partSize > 0 ? partSize : PARTITION_SIZE), ants(ants),
+		iterations(iterations), nodes(0), seeded(false), seedValue(0), built(false)
+{
+}
+
+/**
+ * Empty destructor.
+ */
+HierarchicalSystem::~HierarchicalSystem() { }
+
+/**
+ * Finds the best path from a source node to a destination. The segments
+ * from the source to the borders of its partition and from the borders of
+ * the destination's partition to it join the coarse graph for the query,
+ * while the coarse path is expanded with the segments it uses.
+ *
+ * @param start Path's starting point
+ * @param end Path's end point
+ * @return std::vector<int> The best path
+ */
+std::vector<int> HierarchicalSystem::path(int start, int end)
+{
+	if(!built)
+		build();
+	else
+		refresh();
+	if(start == end || start < 0 || end < 0 || start >= nodes || end >= nodes)
+		return std::vector<int>();
+
+	Partition& first = regions[parts[start]];
+	Partition& last = regions[parts[end]];
+	int borders = static_cast<int>(borderNodes.size());
+	bool startBorder = coarseIds[start] != -1;
+	bool endBorder = coarseIds[end] != -1;
+	int source = startBorder ? coarseIds[start] : borders;
+	int destination = endBorder ? coarseIds[end] : borders + 1;
+
+	// Find the segments that attach the endpoints to the coarse graph
+	std::vector<std::pair<int, int>> wanted;
+	if(!startBorder)
+		for(int border : first.borders)
+			wanted.emplace_back(start, border);
+	if(&first == &last && !startBorder && !endBorder)
+		wanted.emplace_back(start, end);
+	solve(first, wanted);
+	std::vector<std::pair<int, int>> attached(wanted);
+	wanted.clear();
+	if(!endBorder)
+		for(int border : last.borders)
+			wanted.emplace_back(border, end);
+	solve(last, wanted);
+	attached.insert(attached.end(), wanted.begin(), wanted.end());
+
+	std::vector<std::pair<int, int>> temporary;
+	for(auto& pair : attached)
+	{
+		Partition& part = regions[parts[pair.first]];
+		const Segment& segment = part.segments[key(pair.first, pair.second)];
+		if(segment.path.empty())
+			continue;
+		int from = pair.first == start ? source : coarseIds[pair.first];
+		int to = pair.second == end ? destination : coarseIds[pair.second];
+		coarse->insertEdge(from, to, segment.length);
+		temporary.emplace_back(from, to);
+	}
+	std::vector<int> coarsePath = coarse->path(source, destination);
+	for(auto& edge : temporary)
+		coarse->removeEdge(edge.first, edge.second);
+
+	// Expand the coarse path with the segments inside partitions
+	auto node = [&](int id)
+	{
+		return id < borders ? borderNodes[id] : id == borders ? start : end;
+	};
+	std::vector<int> route;
+	for(unsigned int index = 0; index < coarsePath.size(); ++index)
+	{
+		int to = node(coarsePath[index]);
+		if(index == 0)
+		{
+			route.push_back(to);
+			continue;
+		}
+		int from = node(coarsePath[index - 1]);
+		if(parts[from] != parts[to])
+		{
+			route.push_back(to);
+			continue;
+		}
+		const Segment& segment = regions[parts[from]].segments[key(from, to)];
+		route.insert(route.end(), segment.path.begin() + 1, segment.path.end());
+	}
+
+	// Consecutive segments of a partition may cross, so erase the loops
+	std::unordered_map<int, int> positions;
+	std::vector<int> best;
+	for(int hop : route)
+	{
+		auto it = positions.find(hop);
+		if(it != positions.end())
+		{
+			for(unsigned int index = it->second + 1; index < best.size(); ++index)
+				positions.erase(best[index]);
+			best.resize(it->second + 1);
+			continue;
+		}
+		positions[hop] = static_cast<int>(best.size());
+		best.push_back(hop);
+	}
+
+	return best;
+}
+
+/**
+ * Removes all edges and partitions.
+ */
+void HierarchicalSystem::clear()
+{
+	edges.clear();
+	regions.clear();
+	coarse.reset();
+	nodes = 0;
+	built = false;
+}
+
+/**
+ * Inserts an edge, after which the partitions are rebuilt by the next query.
+ * Edges repeating an earlier one are dropped then, unless the partitions 
+ * are built and reject them at once.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @param weight Weight for the edge
+ */
+void HierarchicalSystem::insertEdge(int src, int dest, double weight)
+{
+	if(built && findSlot(src, dest) != -1)
+		throw std::invalid_argument("edge " + std::to_string(src) + " -> " 
+				+ std::to_string(dest) + " exists already");
+	AdaptiveSystem::insertEdge(src, dest, weight);
+	nodes = std::max(nodes, std::max(src, dest) + 1);
+	built = false;
+}
+
+/**
+ * Removes an edge, after which the partitions are rebuilt by the next query.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @return bool The indication of an existing edge being removed
+ */
+bool HierarchicalSystem::removeEdge(int src, int dest)
+{
+	if(!AdaptiveSystem::removeEdge(src, dest))
+		return false;
+
+	built = false;
+	return true;
+}
+
+/**
+ * Updates the weight of an edge. An edge inside a partition only makes its
+ * segments stale, which keeps the partition's pheromone, while a crossing
+ * edge is updated upon the coarse graph.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @param weight New weight for the edge
+ * @return bool The indication of an existing edge being updated
+ */
+bool HierarchicalSystem::updateEdge(int src, int dest, double weight)
+{
+	if(!built)
+		return AdaptiveSystem::updateEdge(src, dest, weight);
+
+	int slot = findSlot(src, dest);
+	if(slot == -1)
+		return false;
+
+	edges[edgeIds[slot]].weight = weight;
+	if(parts[src] == parts[dest])
+	{
+		Partition& part = regions[parts[src]];
+		part.colony->updateEdge(locals[src], locals[dest], weight);
+		part.stale = true;
+	}
+	else
+		coarse->updateEdge(coarseIds[src], coarseIds[dest], weight);
+
+	return true;
+}
+
+/**
+ * Sets the partition of the nodes instead of growing them, e.g., from an
+ * external partitioner or the regions of the deployment. Nodes without a
+ * non-negative partition are grown into partitions of their own.
+ *
+ * @param assignment The partition of every node
+ */
+void HierarchicalSystem::setPartitions(const std::vector<int>& assignment)
+{
+	requested = assignment;
+	built = false;
+}
+
+/**
+ * Sets the number of threads that find the segments of the partitions in
+ * parallel.
+ *
+ * @param threads Number of worker threads, with 0 meaning all hardware threads
+ */
+void HierarchicalSystem::setThreads(int threads)
+{
+	if(threads <= 0)
+		threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	pool.reset(threads > 1 ? new ThreadPool(threads) : nullptr);
+}
+
+/**
+ * Sets the update strategy of the colonies of both levels.
+ *
+ * @param strategy The update strategy
+ */
+void HierarchicalSystem::setStrategy(const AntSystem::Strategy& strategy)
+{
+	this->strategy = strategy;
+	if(coarse)
+		coarse->setStrategy(strategy);
+	for(auto& part : regions)
+		part.colony->setStrategy(strategy);
+}
+
+/**
+ * Seeds the random streams of all colonies in a deterministic way.
+ *
+ * @param value The seed
+ */
+void HierarchicalSystem::seed(std::uint64_t value)
+{
+	seeded = true;
+	seedValue = value;
+	if(coarse)
+		coarse->seed(value);
+	for(unsigned int index = 0; index < regions.size(); ++index)
+		regions[index].colony->seed(value + index + 1);
+}
+
+/**
+ * Returns the number of partitions, building them when needed.
+ *
+ * @return int The number of partitions
+ */
+int HierarchicalSystem::partitions()
+{
+	if(!built)
+		build();
+
+	return static_cast<int>(regions.size());
+}
+
+/**
+ * Hint about the number of nodes before edges are inserted.
+ *
+ * @param nodes Expected number of nodes
+ */
+void HierarchicalSystem::reserveNodes(int nodes)
+{
+	this->nodes = std::max(this->nodes, nodes);
+}
+
+/**
+ * Returns the number of nodes, including the ones without edges.
+ *
+ * @return int Number of nodes
+ */
+int HierarchicalSystem::nodeCount() const
+{
+	return std::max(nodes, AdaptiveSystem::nodeCount());
+}
+
+/**
+ * Returns the key of a segment.
+ *
+ * @param from The segment's starting node
+ * @param to The segment's ending node
+ * @return std::uint64_t The key
+ */
+std::uint64_t HierarchicalSystem::key(int from, int to)
+{
+	return static_cast<std::uint64_t>(static_cast<std::uint32_t>(from)) << 32
+			| static_cast<std::uint32_t>(to);
+}
+
+/**
+ * Builds the adjacency, the partitions with their colonies and segments,
+ * and the coarse graph.
+ */
+void HierarchicalSystem::build()
+{
+	// The colonies hold one edge per pair of nodes
+	dropDuplicates();
+	for(auto& edge : edges)
+		nodes = std::max(nodes, std::max(edge.edgeStart, edge.edgeEnd) + 1);
+
+	// Sort the edges by starting node and by ending node
+	starts.assign(nodes + 1, 0);
+	reverseStarts.assign(nodes + 1, 0);
+	for(auto& edge : edges)
+	{
+		++starts[edge.edgeStart + 1];
+		++reverseStarts[edge.edgeEnd + 1];
+	}
+	for(int node = 0; node < nodes; ++node)
+	{
+		starts[node + 1] += starts[node];
+		reverseStarts[node + 1] += reverseStarts[node];
+	}
+	std::vector<int> next(starts.begin(), starts.end() - 1);
+	std::vector<int> reverseNext(reverseStarts.begin(), reverseStarts.end() - 1);
+	targets.resize(edges.size());
+	edgeIds.resize(edges.size());
+	sources.resize(edges.size());
+	for(auto& edge : edges)
+	{
+		int slot = next[edge.edgeStart]++;
+		targets[slot] = edge.edgeEnd;
+		edgeIds[slot] = static_cast<int>(edge.id);
+		sources[reverseNext[edge.edgeEnd]++] = edge.edgeStart;
+	}
+
+	grow();
+
+	// Nodes with an edge to or from another partition are borders
+	coarseIds.assign(nodes, -1);
+	borderNodes.clear();
+	for(auto& edge : edges)
+		if(parts[edge.edgeStart] != parts[edge.edgeEnd])
+			for(int node : {edge.edgeStart, edge.edgeEnd})
+				if(coarseIds[node] == -1)
+				{
+					coarseIds[node] = static_cast<int>(borderNodes.size());
+					borderNodes.push_back(node);
+					regions[parts[node]].borders.push_back(node);
+				}
+
+	// Every partition runs its own colony upon its inner edges, keeping
+	// the pheromone of each destination apart
+	locals.assign(nodes, 0);
+	for(unsigned int index = 0; index < regions.size(); ++index)
+	{
+		Partition& part = regions[index];
+		for(unsigned int local = 0; local < part.nodes.size(); ++local)
+			locals[part.nodes[local]] = local;
+		part.colony.reset(new AntSystem(ants, iterations));
+		part.colony->setWarmStart(static_cast<int>(part.borders.size()) + 2, 0);
+		part.colony->setStrategy(strategy);
+		if(seeded)
+			part.colony->seed(seedValue + index + 1);
+		part.stale = true;
+	}
+	for(auto& edge : edges)
+		if(parts[edge.edgeStart] == parts[edge.edgeEnd])
+			regions[parts[edge.edgeStart]].colony->insertEdge(locals[edge.edgeStart],
+					locals[edge.edgeEnd], edge.weight);
+
+	// The coarse graph holds the crossing edges, then the segments. Its
+	// trails start afresh for every destination, as the coarse node of a
+	// query's destination stands for another node in the next query.
+	coarse.reset(new AntSystem(ants, iterations));
+	coarse->setWarmStart(1, 0);
+	coarse->setStrategy(strategy);
+	if(seeded)
+		coarse->seed(seedValue);
+	for(auto& edge : edges)
+		if(parts[edge.edgeStart] != parts[edge.edgeEnd])
+			coarse->insertEdge(coarseIds[edge.edgeStart], coarseIds[edge.edgeEnd],
+					edge.weight);
+	built = true;
+	refresh();
+}
+
+/**
+ * Assigns every node to a partition, keeping the requested ones and
+ * growing the rest as regions of bounded size in breadth-first order
+ * upon the edges of both directions.
+ */
+void HierarchicalSystem::grow()
+{
+	parts.assign(nodes, -1);
+	std::unordered_map<int, int> renumbered;
+	for(int node = 0; node < nodes && node < (int)requested.size(); ++node)
+		if(requested[node] >= 0)
+			parts[node] = renumbered.emplace(requested[node],
+					(int)renumbered.size()).first->second;
+	int count = static_cast<int>(renumbered.size());
+
+	std::vector<int> queue;
+	for(int seed = 0; seed < nodes; ++seed)
+	{
+		if(parts[seed] != -1)
+			continue;
+		queue.assign(1, seed);
+		parts[seed] = count;
+		for(unsigned int head = 0; head < queue.size()
+				&& (int)queue.size() < partSize; ++head)
+		{
+			int node = queue[head];
+			auto visit = [&](int neighbour)
+			{
+				if(parts[neighbour] == -1 && (int)queue.size() < partSize)
+				{
+					parts[neighbour] = count;
+					queue.push_back(neighbour);
+				}
+			};
+			for(int slot = starts[node]; slot < starts[node + 1]; ++slot)
+				visit(targets[slot]);
+			for(int slot = reverseStarts[node]; slot < reverseStarts[node + 1]; ++slot)
+				visit(sources[slot]);
+		}
+		++count;
+	}
+
+	regions.clear();
+	regions.resize(count);
+	for(int node = 0; node < nodes; ++node)
+		regions[parts[node]].nodes.push_back(node);
+}
+
+/**
+ * Finds the segments between all border nodes of a partition.
+ *
+ * @param part The partition
+ */
+void HierarchicalSystem::connect(Partition& part)
+{
+	part.segments.clear();
+	std::vector<std::pair<int, int>> wanted;
+	for(int from : part.borders)
+		for(int to : part.borders)
+			if(from != to)
+				wanted.emplace_back(from, to);
+	solve(part, wanted);
+}
+
+/**
+ * Finds the segments of the given pairs of a partition that are not yet
+ * cached, by one colony per destination.
+ *
+ * @param part The partition
+ * @param wanted The pairs of nodes
+ */
+void HierarchicalSystem::solve(Partition& part,
+		const std::vector<std::pair<int, int>>& wanted)
+{
+	std::vector<std::pair<int, int>> pairs;
+	for(auto& pair : wanted)
+		if(part.segments.find(key(pair.first, pair.second)) == part.segments.end())
+			pairs.emplace_back(locals[pair.first], locals[pair.second]);
+	if(pairs.empty())
+		return;
+
+	std::vector<std::vector<int>> found = part.colony->paths(pairs);
+	for(unsigned int index = 0; index < pairs.size(); ++index)
+	{
+		Segment segment;
+		segment.length = 0;
+		for(int local : found[index])
+		{
+			int node = part.nodes[local];
+			if(!segment.path.empty())
+				segment.length += edges[edgeIds[findSlot(segment.path.back(),
+						node)]].weight;
+			segment.path.push_back(node);
+		}
+		part.segments[key(part.nodes[pairs[index].first],
+				part.nodes[pairs[index].second])] = std::move(segment);
+	}
+}
+
+/**
+ * Finds again the segments between the borders of stale partitions, in
+ * parallel, and replaces them upon the coarse graph.
+ */
+void HierarchicalSystem::refresh()
+{
+	std::vector<Partition*> stale;
+	for(auto& part : regions)
+		if(part.stale)
+		{
+			for(int from : part.borders)
+				for(int to : part.borders)
+				{
+					auto it = part.segments.find(key(from, to));
+					if(it != part.segments.end() && !it->second.path.empty())
+						coarse->removeEdge(coarseIds[from], coarseIds[to]);
+				}
+			stale.push_back(&part);
+		}
+	if(stale.empty())
+		return;
+
+	int workers = pool ? pool->size() : 1;
+	int total = static_cast<int>(stale.size());
+	auto work = [&](int worker)
+	{
+		int last = static_cast<int>(static_cast<long int>(total)
+				* (worker + 1) / workers);
+		int first = static_cast<int>(static_cast<long int>(total)
+				* worker / workers);
+		for(int index = first; index < last; ++index)
+			connect(*stale[index]);
+	};
+	if(pool)
+		pool->run(work);
+	else
+		work(0);
+
+	for(Partition* part : stale)
+	{
+		for(int from : part->borders)
+			for(int to : part->borders)
+			{
+				auto it = part->segments.find(key(from, to));
+				if(it != part->segments.end() && !it->second.path.empty())
+					coarse->insertEdge(coarseIds[from], coarseIds[to],
+							it->second.length);
+			}
+		part->stale = false;
+	}
+}
+
+/**
+ * Returns the slot of an edge inside the adjacency of the whole topology.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @return int The slot or -1 when no such edge exists
+ */
+int HierarchicalSystem::findSlot(int src, int dest) const
+{
+	if(src < 0 || src >= nodes)
+		return -1;
+	for(int slot = starts[src]; slot < starts[src + 1]; ++slot)
+		if(targets[slot] == dest)
+			return slot;
+
+	return -1;
+}
@@ -0,0 +1,120 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef HIERARCHICALSYSTEM_H
+#define HIERARCHICALSYSTEM_H
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <utility>
+#include "antsystem.h"
+
+/**
+ * Two-level Ant System for topologies too large for a flat colony. The
+ * nodes are split into partitions, either grown as regions around seed
+ * nodes or given by the caller, e.g., from METIS. A colony per partition
+ * finds the segments between its border nodes, i.e., the nodes with an
+ * edge to another partition, and a coarse colony runs upon the border
+ * nodes, whose edges are the crossing edges and the segments. Segments
+ * are cached per partition until its topology changes.
+ */
+class HierarchicalSystem : public AdaptiveSystem
+{
+public:
+	static const int PARTITION_SIZE = 256;
+	HierarchicalSystem(const std::string&, int = PARTITION_SIZE, int = 0, int = 0);
+	HierarchicalSystem(int = PARTITION_SIZE, int = 0, int = 0);
+	virtual ~HierarchicalSystem();
+	virtual std::vector<int> path(int, int);
+	virtual void clear();
+	virtual void insertEdge(int, int, double) noexcept(false);
+	virtual bool removeEdge(int, int);
+	virtual bool updateEdge(int, int, double);
+	void setPartitions(const std::vector<int>&);
+	void setThreads(int);
+	void setStrategy(const AntSystem::Strategy&);
+	void seed(std::uint64_t);
+	int partitions();
+
+protected:
+	virtual void reserveNodes(int);
+	virtual int nodeCount() const;
+
+private:
+	// Best path found between two nodes of a partition, empty when none
+	struct Segment
+	{
+		std::vector<int> path;
+		double length;
+	};
+
+	struct Partition
+	{
+		// The partition's nodes, where a node's local ID is its position
+		std::vector<int> nodes;
+		std::vector<int> borders;
+		std::unique_ptr<AntSystem> colony;
+		std::unordered_map<std::uint64_t, Segment> segments;
+		// Set when an edge inside changed after the segments were found
+		bool stale;
+	};
+
+	static std::uint64_t key(int, int);
+	void build();
+	void grow();
+	void connect(Partition&);
+	void solve(Partition&, const std::vector<std::pair<int, int>>&);
+	void refresh();
+	int findSlot(int, int) const;
+	int partSize;
+	int ants;
+	int iterations;
+	int nodes;
+	bool seeded;
+	std::uint64_t seedValue;
+	AntSystem::Strategy strategy;
+	// Set after the partitions are built and cleared by structural changes
+	bool built;
+	// Partitions asked by the caller per node, -1 for the ones to be grown
+	std::vector<int> requested;
+	std::unique_ptr<ThreadPool> pool;
+	// Compressed-sparse-row adjacency of the whole topology and its reverse
+	std::vector<int> starts;
+	std::vector<int> targets;
+	std::vector<int> edgeIds;
+	std::vector<int> reverseStarts;
+	std::vector<int> sources;
+	// Partition and local ID of every node
+	std::vector<int> parts;
+	std::vector<int> locals;
+	std::vector<Partition> regions;
+	// Coarse ID of every border node and vice versa, where the two IDs after
+	// the border nodes stand for a query's source and destination
+	std::vector<int> coarseIds;
+	std::vector<int> borderNodes;
+	std::unique_ptr<AntSystem> coarse;
+};
+
+#endif // HIERARCHICALSYSTEM_H
@@ -0,0 +1,243 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "hybridsystem.h"
+
+/**
+ * Constructor initialising the colony's topology from external file.
+ *
+ * @param filename A file containing the topology in JSON format or a snapshot
+ * @param ants Number of ants to unlease in each iteration
+ * @param iterations Number of iterations
+ */
+HybridSystem::HybridSystem(const std::string& filename, int ants, int iterations) 
+		: colony(filename, ants, iterations), exact(colony), iterationTime(0), 
+		fallbacks(0)
+{
+}
+
+/**
+ * Constructor w/out initialising the topology.
+ *
+ * @param ants Number of ants to unlease in each iteration
+ * @param iterations Number of iterations
+ */
+HybridSystem::HybridSystem(int ants, int iterations) : colony(ants, iterations), 
+		exact(colony), iterationTime(0), fallbacks(0)
+{
+}
+
+/**
+ * Empty destructor.
+ */
+HybridSystem::~HybridSystem() { }
+
+/**
+ * Finds the best path from a source node to a destination.
+ *
+ * @param start Path's starting point
+ * @param end Path's end point
+ * @return std::vector<int> The best path, empty only when there is none
+ */
+std::vector<int> HybridSystem::path(int start, int end)
+{
+	return query(start, end).path;
+}
+
+/**
+ * Runs the colony, whose trails follow the exact path after a topology 
+ * change, and answers with the exact path when the colony finds none or 
+ * the deadline is too tight for it. Every answer skipping the colony 
+ * lowers the estimated time per iteration, until the colony runs again 
+ * and measures it anew.
+ *
+ * @param start Path's starting point
+ * @param end Path's end point
+ * @return Result The best path, its length and why the colony stopped, 
+ * with no iterations when the colony did not run
+ */
+AntSystem::Result HybridSystem::query(int start, int end)
+{
+	double room = static_cast<double>(MIN_ITERATIONS);
+	if(criteria.deadline.count() > 0 && iterationTime.count() > 0 
+			&& iterationTime * room > criteria.deadline)
+	{
+		ExactSystem::Result shortest = exact.query(start, end);
+		++fallbacks;
+		iterationTime *= PROBE_DECAY;
+		return {shortest.path, shortest.length, 0, AntSystem::StopReason::DEADLINE};
+	}
+
+	auto began = std::chrono::steady_clock::now();
+	AntSystem::Result found = colony.query(start, end, [this](int from, int to)
+			{
+				return exact.path(from, to);
+			});
+	if(found.iterations > 0)
+	{
+		std::chrono::duration<double, std::milli> elapsed = (std::chrono::steady_clock::now() 
+				- began) / found.iterations;
+		iterationTime = iterationTime.count() > 0 ? 0.8 * iterationTime + 0.2 * elapsed 
+				: elapsed;
+	}
+	if(found.path.empty())
+	{
+		ExactSystem::Result shortest = exact.query(start, end);
+		if(!shortest.path.empty())
+			++fallbacks;
+		found.path = shortest.path;
+		found.length = shortest.length;
+	}
+
+	return found;
+}
+
+/**
+ * Removes all edges of the topology.
+ */
+void HybridSystem::clear()
+{
+	colony.clear();
+}
+
+/**
+ * Inserts an edge into the topology, which the exact search reads as well.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @param weight Weight for the edge
+ */
+void HybridSystem::insertEdge(int src, int dest, double weight)
+{
+	colony.insertEdge(src, dest, weight);
+}
+
+/**
+ * Removes an edge from the topology.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @return bool The indication of an existing edge being removed
+ */
+bool HybridSystem::removeEdge(int src, int dest)
+{
+	return colony.removeEdge(src, dest);
+}
+
+/**
+ * Updates the weight of an edge of the topology.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @param weight New weight for the edge
+ * @return bool The indication of an existing edge being updated
+ */
+bool HybridSystem::updateEdge(int src, int dest, double weight)
+{
+	return colony.updateEdge(src, dest, weight);
+}
+
+/**
+ * Writes the topology, along with the colony's pheromone, as a snapshot.
+ * 
+ * @param filename The snapshot file
+ */
+void HybridSystem::saveSnapshot(const std::string& filename)
+{
+	colony.saveSnapshot(filename);
+}
+
+/**
+ * Sets the number of threads of the colony.
+ *
+ * @param threads Number of threads
+ */
+void HybridSystem::setThreads(int threads)
+{
+	colony.setThreads(threads);
+}
+
+/**
+ * Seeds the random streams of the colony.
+ *
+ * @param value The seed
+ */
+void HybridSystem::seed(std::uint64_t value)
+{
+	colony.seed(value);
+}
+
+/**
+ * Sets the pheromone tables kept per destination and the iterations of a 
+ * warm-started colony.
+ *
+ * @param capacity Number of tables
+ * @param iterations Iterations when warm-started
+ */
+void HybridSystem::setWarmStart(int capacity, int iterations)
+{
+	colony.setWarmStart(capacity, iterations);
+}
+
+/**
+ * Sets the stopping criteria of the colony, whose deadline also decides 
+ * whether the colony runs at all.
+ *
+ * @param criteria The criteria
+ */
+void HybridSystem::setStopCriteria(const AntSystem::StopCriteria& criteria)
+{
+	this->criteria = criteria;
+	colony.setStopCriteria(criteria);
+}
+
+/**
+ * Sets the strategy of the colony.
+ *
+ * @param strategy The strategy
+ */
+void HybridSystem::setStrategy(const AntSystem::Strategy& strategy)
+{
+	colony.setStrategy(strategy);
+}
+
+/**
+ * Sets the lower bound of the exact search's remaining distance.
+ *
+ * @param heuristic The bound
+ */
+void HybridSystem::setHeuristic(const ExactSystem::Heuristic& heuristic)
+{
+	exact.setHeuristic(heuristic);
+}
+
+/**
+ * Returns the number of queries answered by the exact path alone.
+ *
+ * @return long The number
+ */
+long HybridSystem::exactAnswers() const
+{
+	return fallbacks;
+}
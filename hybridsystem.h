@@ -0,0 +1,78 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef HYBRIDSYSTEM_H
+#define HYBRIDSYSTEM_H
+
+#include <chrono>
+#include <cstdint>
+#include "antsystem.h"
+#include "exactsystem.h"
+
+/**
+ * Ant System backed by exact searches upon the colony's own adjacency. After every 
+ * change of the topology or its weights, the first query to a destination 
+ * lays a trail along the exact path before the ants walk, which persists 
+ * with warm-started tables. The exact path answers when the colony finds 
+ * no path or when the deadline leaves no room for enough iterations, as 
+ * estimated from the colony's last runs.
+ */
+class HybridSystem : public AdaptiveSystem
+{
+public:
+	// Iterations a deadline must leave room for, or the exact path answers
+	static const int MIN_ITERATIONS = 10;
+	// Shrinkage of the time per iteration with every exact answer due to the 
+	// deadline, so that the colony runs again, e.g., upon a lighter load
+	static constexpr double PROBE_DECAY = 0.8;
+	HybridSystem(const std::string&, int = 0, int = 0);
+	HybridSystem(int = 0, int = 0);
+	virtual ~HybridSystem();
+	virtual std::vector<int> path(int, int);
+	AntSystem::Result query(int, int);
+	virtual void clear();
+	virtual void insertEdge(int, int, double) noexcept(false);
+	virtual bool removeEdge(int, int);
+	virtual bool updateEdge(int, int, double);
+	virtual void saveSnapshot(const std::string&) noexcept(false);
+	void setThreads(int);
+	void seed(std::uint64_t);
+	void setWarmStart(int, int);
+	void setStopCriteria(const AntSystem::StopCriteria&);
+	void setStrategy(const AntSystem::Strategy&);
+	void setHeuristic(const ExactSystem::Heuristic&);
+	long exactAnswers() const;
+
+private:
+	AntSystem colony;
+	// Searches the colony's topology, which is held once
+	ExactSystem exact;
+	AntSystem::StopCriteria criteria;
+	// Moving average of the colonies' time per iteration, 0 before the first
+	std::chrono::duration<double, std::milli> iterationTime;
+	// Queries answered by the exact path instead of the colony
+	long fallbacks;
+};
+
+#endif // HYBRIDSYSTEM_H
@@ -0,0 +1,348 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+#include "islandring.h"
+
+/**
+ * Constructor that listens for the previous island and connects to the
+ * next one, waiting up to the timeout for both.
+ *
+ * @param port The port to listen on for the previous island
+ * @param host The host of the next island
+ * @param nextPort The port of the next island
+ * @param timeout Maximum waiting time for a neighbour
+ */
+IslandRing::IslandRing(int port, const std::string& host, int nextPort,
+		std::chrono::milliseconds timeout) : listener(-1), next(-1), previous(-1),
+		timeout(timeout), capacity(MAX_MESSAGE)
+{
+#if defined(__unix__) || defined(__APPLE__)
+	listener = ::socket(AF_INET, SOCK_STREAM, 0);
+	int yes = 1;
+	::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+	sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(static_cast<std::uint16_t>(port));
+	if(listener == -1 || ::bind(listener, reinterpret_cast<sockaddr*>(&address),
+			sizeof(address)) != 0 || ::listen(listener, 1) != 0)
+	{
+		disconnect();
+		throw std::runtime_error("port " + std::to_string(port) + ": cannot listen");
+	}
+
+	// The next island may not listen yet, so retry until the deadline
+	addrinfo hints{};
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo* found = nullptr;
+	if(::getaddrinfo(host.c_str(), std::to_string(nextPort).c_str(), &hints, &found) != 0)
+	{
+		disconnect();
+		throw std::runtime_error(host + ": cannot resolve host");
+	}
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+	while(next == -1 && std::chrono::steady_clock::now() < deadline)
+	{
+		next = ::socket(found->ai_family, found->ai_socktype, found->ai_protocol);
+		if(next != -1 && ::connect(next, found->ai_addr, found->ai_addrlen) != 0)
+		{
+			::close(next);
+			next = -1;
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		}
+	}
+	::freeaddrinfo(found);
+
+	pollfd waiting{listener, POLLIN, 0};
+	int left = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+			deadline - std::chrono::steady_clock::now()).count());
+	if(next != -1 && ::poll(&waiting, 1, std::max(left, 0)) == 1)
+		previous = ::accept(listener, nullptr, nullptr);
+	if(next == -1 || previous == -1)
+	{
+		disconnect();
+		throw std::runtime_error("island ring: neighbour not reached in time");
+	}
+	::setsockopt(next, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+	for(int fd : {next, previous})
+		::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+#else
+	throw std::runtime_error("island ring: sockets not supported");
+#endif
+}
+
+/**
+ * Destructor that closes the links.
+ */
+IslandRing::~IslandRing()
+{
+	disconnect();
+}
+
+/**
+ * Sends the best tours to the next island and receives the ones of the
+ * previous island. Every island must exchange as many times as the others.
+ *
+ * @param tours The best tours of this island
+ * @return std::vector<std::vector<int>> The best tours of the previous
+ * island, none once the ring is broken
+ */
+std::vector<std::vector<int>> IslandRing::exchange(
+		const std::vector<std::vector<int>>& tours)
+{
+	if(!connected())
+		return std::vector<std::vector<int>>();
+
+	// Messages are framed by their length in little-endian order
+	std::string message = encode(tours);
+	std::string frame(4, '\0');
+	for(int i = 0; i < 4; ++i)
+		frame[i] = static_cast<char>(message.size() >> (8 * i));
+	std::string received;
+	if(transfer(frame + message, received))
+	{
+		try
+		{
+			return decode(received);
+		}
+		catch(std::exception& e)
+		{
+			std::cerr << e.what() << std::endl;
+		}
+	}
+
+	std::cerr << "island ring: neighbour lost, going on alone" << std::endl;
+	disconnect();
+	return std::vector<std::vector<int>>();
+}
+
+/**
+ * Returns the indication of both neighbours being linked.
+ *
+ * @return bool The indication
+ */
+bool IslandRing::connected() const
+{
+	return next != -1 && previous != -1;
+}
+
+/**
+ * Limits the size of a received message to the largest encoding of the 
+ * given tours, each one visiting every node at most once.
+ *
+ * @param nodes Number of nodes of the topology
+ * @param tours Number of tours of an exchange, i.e., the sources of a query
+ */
+void IslandRing::setCapacity(int nodes, int tours)
+{
+	std::uint64_t largest = MAX_VARINT + static_cast<std::uint64_t>(std::max(tours, 0)) 
+			* (MAX_VARINT + static_cast<std::uint64_t>(std::max(nodes, 0)) * MAX_VARINT);
+	capacity = static_cast<std::uint32_t>(std::min(largest, static_cast<std::uint64_t>(MAX_MESSAGE)));
+}
+
+/**
+ * Encodes tours as the number of tours, then the number of nodes of each
+ * tour followed by its first node and the differences between consecutive
+ * nodes, all as zigzag variable-length integers.
+ *
+ * @param tours The tours
+ * @return std::string The encoded tours
+ */
+std::string IslandRing::encode(const std::vector<std::vector<int>>& tours)
+{
+	std::string out;
+	auto put = [&out](std::int64_t value)
+	{
+		std::uint64_t zigzag = (static_cast<std::uint64_t>(value) << 1)
+				^ static_cast<std::uint64_t>(value >> 63);
+		do
+		{
+			char byte = static_cast<char>(zigzag & 0x7f);
+			zigzag >>= 7;
+			out.push_back(zigzag ? static_cast<char>(byte | 0x80) : byte);
+		} while(zigzag);
+	};
+
+	put(static_cast<std::int64_t>(tours.size()));
+	for(auto& tour : tours)
+	{
+		put(static_cast<std::int64_t>(tour.size()));
+		std::int64_t last = 0;
+		for(int node : tour)
+		{
+			put(node - last);
+			last = node;
+		}
+	}
+
+	return out;
+}
+
+/**
+ * Decodes tours encoded by encode().
+ *
+ * @param in The encoded tours
+ * @return std::vector<std::vector<int>> The tours
+ */
+std::vector<std::vector<int>> IslandRing::decode(const std::string& in)
+{
+	size_t pos = 0;
+	auto get = [&in, &pos]()
+	{
+		std::uint64_t zigzag = 0;
+		for(int shift = 0;; shift += 7)
+		{
+			if(pos >= in.size() || shift > 63)
+				throw std::runtime_error("island ring: malformed message");
+			unsigned char byte = static_cast<unsigned char>(in[pos++]);
+			zigzag |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+			if(!(byte & 0x80))
+				break;
+		}
+		return static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+	};
+
+	std::vector<std::vector<int>> tours;
+	std::int64_t count = get();
+	// Every tour and node takes at least a byte
+	if(count < 0 || count > static_cast<std::int64_t>(in.size()))
+		throw std::runtime_error("island ring: malformed message");
+	tours.resize(count);
+	for(auto& tour : tours)
+	{
+		std::int64_t size = get();
+		if(size < 0 || size > static_cast<std::int64_t>(in.size() - pos))
+			throw std::runtime_error("island ring: malformed message");
+		std::int64_t node = 0;
+		for(std::int64_t i = 0; i < size; ++i)
+		{
+			node += get();
+			tour.push_back(static_cast<int>(node));
+		}
+	}
+
+	return tours;
+}
+
+/**
+ * Closes the links and the listening socket.
+ */
+void IslandRing::disconnect()
+{
+#if defined(__unix__) || defined(__APPLE__)
+	for(int* fd : {&listener, &next, &previous})
+		if(*fd != -1)
+		{
+			::close(*fd);
+			*fd = -1;
+		}
+#endif
+}
+
+/**
+ * Sends a framed message to the next island while receiving the one of the 
+ * previous island, polling both links, so that neither island waits for 
+ * the other to receive before it receives in turn.
+ *
+ * @param outgoing The framed message
+ * @param incoming The buffer where the received message, without its 
+ * frame, is placed
+ * @return bool The indication of both messages being transferred in time
+ */
+bool IslandRing::transfer(const std::string& outgoing, std::string& incoming)
+{
+#if defined(__unix__) || defined(__APPLE__)
+	char frame[4];
+	size_t sent = 0;
+	size_t got = 0;
+	// The frame is received first, then the message of the size it tells
+	size_t wanted = sizeof(frame);
+	bool framed = false;
+	while(sent < outgoing.size() || !framed || got < wanted)
+	{
+		// A link done with its transfer is left out, as poll() skips it
+		bool sending = sent < outgoing.size();
+		bool receiving = !framed || got < wanted;
+		pollfd waiting[2] = {{sending ? next : -1, POLLOUT, 0}, 
+				{receiving ? previous : -1, POLLIN, 0}};
+		if(::poll(waiting, 2, static_cast<int>(timeout.count())) <= 0)
+			return false;
+
+		if(sending && waiting[0].revents)
+		{
+			ssize_t count = ::send(next, outgoing.data() + sent, outgoing.size() - sent, 
+					MSG_NOSIGNAL);
+			if(count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+				return false;
+			sent += std::max<ssize_t>(count, 0);
+		}
+		if(receiving && waiting[1].revents)
+		{
+			char* data = framed ? incoming.data() + got : frame + got;
+			ssize_t count = ::recv(previous, data, wanted - got, 0);
+			if(count == 0 || (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK 
+					&& errno != EINTR))
+				return false;
+			got += std::max<ssize_t>(count, 0);
+			if(!framed && got == wanted)
+			{
+				std::uint32_t size = 0;
+				for(int i = 0; i < 4; ++i)
+					size |= static_cast<std::uint32_t>(static_cast<unsigned char>(frame[i])) 
+							<< (8 * i);
+				// A peer must not make this island allocate beyond any valid message
+				if(size > capacity)
+				{
+					std::cerr << "island ring: message of " << size << " bytes is too large" 
+							<< std::endl;
+					return false;
+				}
+				incoming.resize(size);
+				framed = true;
+				got = 0;
+				wanted = size;
+			}
+		}
+	}
+	return true;
+#else
+	return false;
+#endif
+}
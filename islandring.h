@@ -0,0 +1,73 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ISLANDRING_H
+#define ISLANDRING_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+/**
+ * TCP link of a colony to the next and the previous one, e.g., on other
+ * hosts, arranged in a ring. Every exchange sends the colony's best tours
+ * to the next island and returns the ones of the previous island, with the
+ * nodes of each tour encoded as variable-length deltas. Sending and 
+ * receiving proceed together, so that messages larger than the socket 
+ * buffers do not stall the ring. Every island must 
+ * exchange as many times as the others, which colonies do by ignoring their 
+ * early stopping criteria while migrating. An island whose neighbour fails, 
+ * falls behind by more than the timeout, or sends a message larger than the 
+ * capacity goes on alone.
+ */
+class IslandRing
+{
+public:
+	// Largest message accepted before setCapacity() narrows it
+	static const std::uint32_t MAX_MESSAGE = 1 << 26;
+	// Largest encoding of an integer
+	static const int MAX_VARINT = 10;
+	IslandRing(int, const std::string&, int,
+			std::chrono::milliseconds = std::chrono::seconds(10)) noexcept(false);
+	virtual ~IslandRing();
+	IslandRing(const IslandRing&) = delete;
+	IslandRing& operator=(const IslandRing&) = delete;
+	std::vector<std::vector<int>> exchange(const std::vector<std::vector<int>>&);
+	bool connected() const;
+	void setCapacity(int, int);
+	static std::string encode(const std::vector<std::vector<int>>&);
+	static std::vector<std::vector<int>> decode(const std::string&) noexcept(false);
+
+private:
+	void disconnect();
+	bool transfer(const std::string&, std::string&);
+	int listener;
+	int next;
+	int previous;
+	std::chrono::milliseconds timeout;
+	std::uint32_t capacity;
+};
+
+#endif // ISLANDRING_H
@@ -0,0 +1,104 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <fstream>
+#include <sstream>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "mappedfile.h"
+
+/**
+ * Constructor that maps the file read-only in memory, or reads it whole 
+ * where memory mapping isn't available.
+ *
+ * @param filename The file
+ */
+MappedFile::MappedFile(const std::string& filename) : begin(nullptr), length(0), 
+		mapped(false)
+{
+#if defined(__unix__) || defined(__APPLE__)
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if(fd == -1)
+		throw std::runtime_error(filename + ": cannot open file");
+
+	struct stat info;
+	if(::fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		void* addr = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(addr != MAP_FAILED)
+		{
+			::madvise(addr, info.st_size, MADV_SEQUENTIAL);
+			begin = static_cast<const char*>(addr);
+			length = info.st_size;
+			mapped = true;
+		}
+	}
+	::close(fd);
+#endif
+	if(!mapped)
+	{
+		std::ifstream file(filename, std::ios::binary);
+		if(!file)
+			throw std::runtime_error(filename + ": cannot open file");
+		std::ostringstream contents;
+		contents << file.rdbuf();
+		buffer = contents.str();
+		begin = buffer.data();
+		length = buffer.size();
+	}
+}
+
+/**
+ * Destructor that unmaps the file.
+ */
+MappedFile::~MappedFile()
+{
+#if defined(__unix__) || defined(__APPLE__)
+	if(mapped)
+		::munmap(const_cast<char*>(begin), length);
+#endif
+}
+
+/**
+ * Returns the file's contents.
+ *
+ * @return const char* The first byte
+ */
+const char* MappedFile::data() const
+{
+	return begin;
+}
+
+/**
+ * Returns the file's size.
+ *
+ * @return size_t Number of bytes
+ */
+size_t MappedFile::size() const
+{
+	return length;
+}
@@ -0,0 +1,241 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "roulette.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * Finds the first index whose prefix sum of weights reaches the threshold. 
+ * When rounding errors leave the threshold unreached, the last index is 
+ * returned. Blocks of weights are summed in vector registers when AVX2 or 
+ * NEON is available at compile time.
+ *
+ * @param weights The weights of the row
+ * @param size The number of weights, greater than zero
+ * @param value The threshold in range [0, sum of weights]
+ * @return int The chosen index
+ */
+template<>
+int Roulette::spin<double>(const double* weights, int size, double value)
+{
+	int index = 0;
+	double sum = 0;
+#if defined(__AVX2__)
+	const __m256d zero = _mm256_setzero_pd();
+	const __m256d threshold = _mm256_set1_pd(value);
+	__m256d running = zero;
+	for(; index + 4 <= size; index += 4)
+	{
+		// In-register prefix sum of the four lanes, offset by the previous ones
+		__m256d block = _mm256_loadu_pd(weights + index);
+		block = _mm256_add_pd(block, _mm256_blend_pd(
+				_mm256_permute4x64_pd(block, 0x90), zero, 0x1));
+		block = _mm256_add_pd(block, _mm256_blend_pd(
+				_mm256_permute4x64_pd(block, 0x40), zero, 0x3));
+		block = _mm256_add_pd(block, running);
+		int mask = _mm256_movemask_pd(_mm256_cmp_pd(block, threshold, _CMP_GE_OQ));
+		if(mask)
+			return index + __builtin_ctz(mask);
+		running = _mm256_permute4x64_pd(block, 0xff);
+	}
+	sum = _mm256_cvtsd_f64(running);
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	const float64x2_t zero = vdupq_n_f64(0);
+	const float64x2_t threshold = vdupq_n_f64(value);
+	float64x2_t running = zero;
+	for(; index + 2 <= size; index += 2)
+	{
+		float64x2_t block = vld1q_f64(weights + index);
+		block = vaddq_f64(block, vextq_f64(zero, block, 1));
+		block = vaddq_f64(block, running);
+		uint64x2_t mask = vcgeq_f64(block, threshold);
+		if(vgetq_lane_u64(mask, 0))
+			return index;
+		if(vgetq_lane_u64(mask, 1))
+			return index + 1;
+		running = vdupq_laneq_f64(block, 1);
+	}
+	sum = vgetq_lane_f64(running, 0);
+#endif
+
+	return scan(weights, index, size, sum, value);
+}
+
+/**
+ * Single precision variant of the selection, summing twice as many 
+ * weights in each vector register.
+ *
+ * @param weights The weights of the row
+ * @param size The number of weights, greater than zero
+ * @param value The threshold in range [0, sum of weights]
+ * @return int The chosen index
+ */
+template<>
+int Roulette::spin<float>(const float* weights, int size, float value)
+{
+	int index = 0;
+	float sum = 0;
+#if defined(__AVX2__)
+	const __m256 threshold = _mm256_set1_ps(value);
+	const __m256i last = _mm256_set1_epi32(7);
+	__m256 running = _mm256_setzero_ps();
+	for(; index + 8 <= size; index += 8)
+	{
+		// Prefix sums inside both halves, then the lower half's total is 
+		// carried over to the upper one
+		__m256 block = _mm256_loadu_ps(weights + index);
+		block = _mm256_add_ps(block, _mm256_castsi256_ps(
+				_mm256_slli_si256(_mm256_castps_si256(block), 4)));
+		block = _mm256_add_ps(block, _mm256_castsi256_ps(
+				_mm256_slli_si256(_mm256_castps_si256(block), 8)));
+		__m256 carry = _mm256_shuffle_ps(block, block, 0xff);
+		block = _mm256_add_ps(block, _mm256_permute2f128_ps(carry, carry, 0x08));
+		block = _mm256_add_ps(block, running);
+		int mask = _mm256_movemask_ps(_mm256_cmp_ps(block, threshold, _CMP_GE_OQ));
+		if(mask)
+			return index + __builtin_ctz(mask);
+		running = _mm256_permutevar8x32_ps(block, last);
+	}
+	sum = _mm256_cvtss_f32(running);
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	const float32x4_t zero = vdupq_n_f32(0);
+	const float32x4_t threshold = vdupq_n_f32(value);
+	float32x4_t running = zero;
+	for(; index + 4 <= size; index += 4)
+	{
+		float32x4_t block = vld1q_f32(weights + index);
+		block = vaddq_f32(block, vextq_f32(zero, block, 3));
+		block = vaddq_f32(block, vextq_f32(zero, block, 2));
+		block = vaddq_f32(block, running);
+		uint32x4_t mask = vcgeq_f32(block, threshold);
+		for(int lane = 0; lane < 4; ++lane)
+			if(mask[lane])
+				return index + lane;
+		running = vdupq_laneq_f32(block, 3);
+	}
+	sum = vgetq_lane_f32(running, 0);
+#endif
+
+	return scan(weights, index, size, sum, value);
+}
+
+/**
+ * Scalar selection over the weights that remain after the vector blocks.
+ *
+ * @param weights The weights of the row
+ * @param index The first remaining index
+ * @param size The number of weights, greater than zero
+ * @param sum The sum of weights before the first remaining index
+ * @param value The threshold in range [0, sum of weights]
+ * @return int The chosen index
+ */
+template<class T>
+int Roulette::scan(const T* weights, int index, int size, T sum, T value)
+{
+	for(; index < size - 1; ++index)
+	{
+		sum += weights[index];
+		if(value <= sum)
+			break;
+	}
+
+	return index < size ? index : size - 1;
+}
+
+/**
+ * Builds the alias table of a row with Vose's method, so that a neighbour 
+ * can later be sampled in constant time while the weights stay unchanged.
+ *
+ * @param weights The weights of the row
+ * @param size The number of weights
+ * @param sum The sum of weights
+ * @param probs Output with the probability of keeping each column's index
+ * @param aliases Output with the alternative index of each column
+ */
+template<class T>
+void Roulette::buildAlias(const T* weights, int size, double sum, T* probs, 
+		int* aliases)
+{
+	if(size <= 0)
+		return;
+
+	// Scale the weights so that their average is one, then pair every 
+	// column below average with one above it
+	thread_local std::vector<int> small, large;
+	small.clear(); large.clear();
+	for(int index = 0; index < size; ++index)
+	{
+		probs[index] = static_cast<T>(sum > 0 ? weights[index] * size / sum : 1);
+		aliases[index] = index;
+		(probs[index] < 1 ? small : large).push_back(index);
+	}
+
+	while(!small.empty() && !large.empty())
+	{
+		int less = small.back(); small.pop_back();
+		int more = large.back();
+		aliases[less] = more;
+		probs[more] -= 1 - probs[less];
+		if(probs[more] < 1)
+		{
+			large.pop_back();
+			small.push_back(more);
+		}
+	}
+
+	// Whatever remains is full up to rounding errors
+	for(int index : small)
+		probs[index] = 1;
+	for(int index : large)
+		probs[index] = 1;
+}
+
+/**
+ * Samples an index from an alias table.
+ *
+ * @param probs The probabilities of keeping each column's index
+ * @param aliases The alternative index of each column
+ * @param size The number of columns
+ * @param value A uniform random number in range [0, 1)
+ * @return int The chosen index
+ */
+template<class T>
+int Roulette::spinAlias(const T* probs, const int* aliases, int size, double value)
+{
+	double scaled = value * size;
+	int column = static_cast<int>(scaled);
+	if(column >= size)
+		column = size - 1;
+
+	return scaled - column < probs[column] ? column : aliases[column];
+}
+
+template void Roulette::buildAlias<double>(const double*, int, double, double*, int*);
+template void Roulette::buildAlias<float>(const float*, int, double, float*, int*);
+template int Roulette::spinAlias<double>(const double*, const int*, int, double);
+template int Roulette::spinAlias<float>(const float*, const int*, int, double);
@@ -0,0 +1,47 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ROULETTE_H
+#define ROULETTE_H
+
+#include <vector>
+
+class Roulette
+{
+public:
+	template<class T>
+	static int spin(const T*, int, T);
+	template<class T>
+	static void buildAlias(const T*, int, double, T*, int*);
+	template<class T>
+	static int spinAlias(const T*, const int*, int, double);
+
+private:
+	template<class T>
+	static int scan(const T*, int, int, T, T);
+};
+
+template<> int Roulette::spin<double>(const double*, int, double);
+template<> int Roulette::spin<float>(const float*, int, float);
+
+#endif // ROULETTE_H
@@ -0,0 +1,324 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sharedantsystem.h"
+
+/**
+ * Constructor initialising and publishing the topology from external file.
+ *
+ * @param filename A file containing the topology in JSON format or a snapshot
+ * @param ants Number of ants to unlease in each iteration of a query
+ * @param iterations Number of iterations of a query
+ */
+SharedAntSystem::SharedAntSystem(const std::string& filename, int ants,
+		int iterations) : ants(ants), iterations(iterations),
+		master(filename, ants, iterations)
+{
+	publish();
+}
+
+/**
+ * Constructor w/out initialising the topology.
+ *
+ * @param ants Number of ants to unlease in each iteration of a query
+ * @param iterations Number of iterations of a query
+ */
+SharedAntSystem::SharedAntSystem(int ants, int iterations) : ants(ants),
+		iterations(iterations), master(ants, iterations)
+{
+	publish();
+}
+
+/**
+ * Empty destructor.
+ */
+SharedAntSystem::~SharedAntSystem() { }
+
+/**
+ * Finds the best path from a source node to a destination upon the
+ * published topology. Safe to call from many threads at once.
+ *
+ * @param start Path's starting point
+ * @param end Path's end point
+ * @return std::vector<int> The best path
+ */
+std::vector<int> SharedAntSystem::path(int start, int end)
+{
+	return query(start, end).path;
+}
+
+/**
+ * Runs a colony from a source node to a destination upon the published
+ * topology, on an instance that no other query uses meanwhile. Safe to
+ * call from many threads at once.
+ *
+ * @param start Path's starting point
+ * @param end Path's end point
+ * @return AntSystem::Result The best path, its length and why the colony stopped
+ */
+AntSystem::Result SharedAntSystem::query(int start, int end)
+{
+	std::shared_ptr<const Version> version = load();
+	std::unique_ptr<AntSystem> instance = acquire(*version);
+	AntSystem::Result result = instance->query(start, end);
+	release(std::move(instance));
+
+	return result;
+}
+
+/**
+ * Finds the best paths of many source and destination pairs upon the 
+ * published topology. The pairs that share a destination are answered by 
+ * one colony and the colonies of different destinations run in parallel, 
+ * each worker on an instance of its own. Safe to call from many threads 
+ * at once.
+ *
+ * @param pairs The source and destination pairs
+ * @return std::vector<std::vector<int>> The best path of every pair
+ */
+std::vector<std::vector<int>> SharedAntSystem::paths(
+		std::span<const std::pair<int, int>> pairs)
+{
+	// Positions of the pairs per destination
+	std::map<int, std::vector<int>> destinations;
+	for(unsigned int index = 0; index < pairs.size(); ++index)
+		destinations[pairs[index].second].push_back(index);
+	std::vector<std::vector<int>> groups;
+	groups.reserve(destinations.size());
+	for(auto& destination : destinations)
+		groups.push_back(std::move(destination.second));
+
+	std::shared_ptr<const Version> version = load();
+	std::vector<std::vector<int>> bestPaths(pairs.size());
+	std::atomic<int> next(0);
+	auto work = [&](int worker)
+	{
+		// Destinations are taken one at a time, since colonies differ in cost
+		std::unique_ptr<AntSystem> instance;
+		std::vector<std::pair<int, int>> batch;
+		for(int group; (group = next++) < (int)groups.size();)
+		{
+			if(!instance)
+				instance = acquire(*version);
+			batch.clear();
+			for(int index : groups[group])
+				batch.push_back(pairs[index]);
+			std::vector<std::vector<int>> found = instance->paths(batch);
+			for(unsigned int k = 0; k < found.size(); ++k)
+				bestPaths[groups[group][k]] = std::move(found[k]);
+		}
+		if(instance)
+			release(std::move(instance));
+	};
+	// The pool runs one batch at a time, so a batch that finds it busy runs 
+	// on its calling thread instead of waiting
+	std::unique_lock<std::mutex> lock(poolMutex, std::try_to_lock);
+	if(lock.owns_lock() && pool)
+		pool->run(work);
+	else
+		work(0);
+
+	return bestPaths;
+}
+
+/**
+ * Inserts an edge, which becomes visible to the queries once published.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @param weight Weight for the edge
+ */
+void SharedAntSystem::insertEdge(int src, int dest, double weight)
+{
+	std::lock_guard<std::mutex> lock(writer);
+	master.insertEdge(src, dest, weight);
+}
+
+/**
+ * Removes an edge, which disappears from the queries once published.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @return bool The indication of an existing edge being removed
+ */
+bool SharedAntSystem::removeEdge(int src, int dest)
+{
+	std::lock_guard<std::mutex> lock(writer);
+	return master.removeEdge(src, dest);
+}
+
+/**
+ * Updates the weight of an edge, which the queries see once published.
+ *
+ * @param src Starting node
+ * @param dest Ending node
+ * @param weight New weight for the edge
+ * @return bool The indication of an existing edge being updated
+ */
+bool SharedAntSystem::updateEdge(int src, int dest, double weight)
+{
+	std::lock_guard<std::mutex> lock(writer);
+	return master.updateEdge(src, dest, weight);
+}
+
+/**
+ * Writes the current topology, including unpublished changes, as a
+ * binary snapshot.
+ *
+ * @param filename The snapshot file
+ */
+void SharedAntSystem::saveSnapshot(const std::string& filename)
+{
+	std::lock_guard<std::mutex> lock(writer);
+	master.saveSnapshot(filename);
+}
+
+/**
+ * Removes all edges, which the queries see once published.
+ */
+void SharedAntSystem::clear()
+{
+	std::lock_guard<std::mutex> lock(writer);
+	master.clear();
+}
+
+/**
+ * Makes the changes so far visible to the queries that start from now on.
+ * Running queries finish upon the version they started with, which is
+ * released after the last of them. The next change copies the topology.
+ */
+void SharedAntSystem::publish()
+{
+	std::lock_guard<std::mutex> lock(writer);
+	store({master.graph, strategy, criteria});
+}
+
+/**
+ * Sets the update strategy of the queries and publishes it along with
+ * any other change so far.
+ *
+ * @param strategy The update strategy
+ */
+void SharedAntSystem::setStrategy(const AntSystem::Strategy& strategy)
+{
+	std::lock_guard<std::mutex> lock(writer);
+	this->strategy = strategy;
+	store({master.graph, strategy, criteria});
+}
+
+/**
+ * Sets the stopping criteria of the queries and publishes them along with
+ * any other change so far.
+ *
+ * @param criteria The stopping criteria, where zero values are disabled
+ */
+void SharedAntSystem::setStopCriteria(const AntSystem::StopCriteria& criteria)
+{
+	std::lock_guard<std::mutex> lock(writer);
+	this->criteria = criteria;
+	store({master.graph, strategy, criteria});
+}
+
+/**
+ * Sets the number of threads that run the colonies of a batch in parallel,
+ * after any running batch has finished.
+ *
+ * @param threads Number of worker threads, with 0 meaning all hardware threads
+ */
+void SharedAntSystem::setThreads(int threads)
+{
+	if(threads <= 0)
+		threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	std::lock_guard<std::mutex> lock(poolMutex);
+	pool.reset(threads > 1 ? new ThreadPool(threads) : nullptr);
+}
+
+/**
+ * Returns the published version.
+ *
+ * @return std::shared_ptr<const Version> The version
+ */
+std::shared_ptr<const SharedAntSystem::Version> SharedAntSystem::load() const
+{
+#ifdef __cpp_lib_atomic_shared_ptr
+	return current.load(std::memory_order_acquire);
+#else
+	return std::atomic_load_explicit(&current, std::memory_order_acquire);
+#endif
+}
+
+/**
+ * Replaces the published version.
+ *
+ * @param version The new version
+ */
+void SharedAntSystem::store(Version version)
+{
+	auto published = std::make_shared<const Version>(std::move(version));
+#ifdef __cpp_lib_atomic_shared_ptr
+	current.store(std::move(published), std::memory_order_release);
+#else
+	std::atomic_store_explicit(&current, std::move(published), std::memory_order_release);
+#endif
+}
+
+/**
+ * Takes an idle instance, or creates one, and prepares it for a version.
+ * An instance keeps its pheromone levels while the topology stays the same.
+ *
+ * @param version The version to query
+ * @return std::unique_ptr<AntSystem> The instance
+ */
+std::unique_ptr<AntSystem> SharedAntSystem::acquire(const Version& version)
+{
+	std::unique_ptr<AntSystem> instance;
+	{
+		std::lock_guard<std::mutex> lock(idleMutex);
+		if(!idle.empty())
+		{
+			instance = std::move(idle.back());
+			idle.pop_back();
+		}
+	}
+
+	if(instance)
+		instance->adopt(version.graph);
+	else
+		instance.reset(new AntSystem(version.graph, ants, iterations));
+	instance->setStrategy(version.strategy);
+	instance->setStopCriteria(version.criteria);
+
+	return instance;
+}
+
+/**
+ * Returns an instance to the idle ones.
+ *
+ * @param instance The instance
+ */
+void SharedAntSystem::release(std::unique_ptr<AntSystem> instance)
+{
+	std::lock_guard<std::mutex> lock(idleMutex);
+	idle.push_back(std::move(instance));
+}
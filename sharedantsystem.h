@@ -0,0 +1,95 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SHAREDANTSYSTEM_H
+#define SHAREDANTSYSTEM_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <vector>
+#include "antsystem.h"
+
+/**
+ * Ant System that serves queries from many threads at once. All queries
+ * read the same published version of the topology, while each one runs on
+ * an instance with its own pheromone levels, taken from a pool. Changes to
+ * the topology are made upon a private copy and become visible atomically
+ * by publish(), so queries never wait for them. Batches of queries spread
+ * their destinations over CPU worker threads, while DeviceAntSystem runs 
+ * the ants of a colony on a GPU instead.
+ */
+class SharedAntSystem : public AdaptiveSystem
+{
+public:
+	SharedAntSystem(const std::string&, int = 0, int = 0);
+	SharedAntSystem(int = 0, int = 0);
+	virtual ~SharedAntSystem();
+	virtual std::vector<int> path(int, int);
+	AntSystem::Result query(int, int);
+	virtual std::vector<std::vector<int>> paths(std::span<const std::pair<int, int>>);
+	virtual void insertEdge(int, int, double) noexcept(false);
+	virtual bool removeEdge(int, int);
+	virtual bool updateEdge(int, int, double);
+	virtual void saveSnapshot(const std::string&) noexcept(false);
+	virtual void clear();
+	void publish();
+	void setStrategy(const AntSystem::Strategy&);
+	void setStopCriteria(const AntSystem::StopCriteria&);
+	void setThreads(int);
+
+private:
+	// What the queries read, replaced as a whole and never changed
+	struct Version
+	{
+		std::shared_ptr<AntSystem::Graph> graph;
+		AntSystem::Strategy strategy;
+		AntSystem::StopCriteria criteria;
+	};
+
+	std::shared_ptr<const Version> load() const;
+	void store(Version);
+	std::unique_ptr<AntSystem> acquire(const Version&);
+	void release(std::unique_ptr<AntSystem>);
+	int ants;
+	int iterations;
+	// Serialises the changes, which are made upon the master's topology
+	std::mutex writer;
+	AntSystem master;
+	AntSystem::Strategy strategy;
+	AntSystem::StopCriteria criteria;
+#ifdef __cpp_lib_atomic_shared_ptr
+	std::atomic<std::shared_ptr<const Version>> current;
+#else
+	std::shared_ptr<const Version> current;
+#endif
+	// Instances that are not running a query
+	std::mutex idleMutex;
+	std::vector<std::unique_ptr<AntSystem>> idle;
+	// Workers that run the colonies of a batch, one batch at a time
+	std::mutex poolMutex;
+	std::unique_ptr<ThreadPool> pool;
+};
+
+#endif // SHAREDANTSYSTEM_H
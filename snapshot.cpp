@@ -0,0 +1,202 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include "snapshot.h"
+
+static const char MAGIC[8] = {'A', 'C', 'O', 'P', 'A', 'T', 'H', '\0'};
+
+/**
+ * Constructor that maps a snapshot in memory and validates it.
+ *
+ * @param filename The snapshot file
+ */
+Snapshot::Snapshot(const std::string& filename) : file(filename)
+{
+	if(file.size() < sizeof(Header))
+		throw std::runtime_error(filename + ": not a snapshot");
+	std::memcpy(&header, file.data(), sizeof(Header));
+	if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)))
+		throw std::runtime_error(filename + ": not a snapshot");
+	if(header.version != VERSION || header.byteOrder != ORDER_MARK)
+		throw std::runtime_error(filename + ": unsupported snapshot version or byte order");
+
+	// Locate the arrays, each one starting at an eight byte boundary
+	size_t pos = align(sizeof(Header));
+	size_t targetsPos = pos + (header.nodes + 1) * sizeof(std::int64_t);
+	size_t weightsPos = align(targetsPos + header.edges * sizeof(std::int32_t));
+	size_t pherosPos = weightsPos + header.edges * sizeof(double);
+	size_t size = pherosPos + ((header.flags & WITH_PHEROMONE) 
+			? header.edges * sizeof(double) : 0);
+	if(header.nodes > INT32_MAX || header.edges > INT32_MAX || file.size() < size)
+		throw std::runtime_error(filename + ": truncated snapshot");
+
+	rowOffsets = reinterpret_cast<const std::int64_t*>(file.data() + pos);
+	edgeTargets = reinterpret_cast<const std::int32_t*>(file.data() + targetsPos);
+	edgeWeights = reinterpret_cast<const double*>(file.data() + weightsPos);
+	edgePheros = (header.flags & WITH_PHEROMONE) 
+			? reinterpret_cast<const double*>(file.data() + pherosPos) : nullptr;
+
+	if(rowOffsets[0] != 0 || rowOffsets[header.nodes] != (std::int64_t)header.edges)
+		throw std::runtime_error(filename + ": corrupted snapshot");
+	for(std::uint64_t node = 0; node < header.nodes; ++node)
+		if(rowOffsets[node] > rowOffsets[node + 1])
+			throw std::runtime_error(filename + ": corrupted snapshot");
+	for(std::uint64_t edge = 0; edge < header.edges; ++edge)
+		if(edgeTargets[edge] < 0 || (std::uint64_t)edgeTargets[edge] >= header.nodes)
+			throw std::runtime_error(filename + ": corrupted snapshot");
+}
+
+/**
+ * Detects whether a file is a snapshot by its magic bytes.
+ *
+ * @param filename The file
+ * @return bool The indication of a snapshot
+ */
+bool Snapshot::probe(const std::string& filename)
+{
+	char magic[sizeof(MAGIC)] = {};
+	std::ifstream file(filename, std::ios::binary);
+	file.read(magic, sizeof(magic));
+
+	return file && !std::memcmp(magic, MAGIC, sizeof(MAGIC));
+}
+
+/**
+ * Writes a snapshot.
+ *
+ * @param filename The snapshot file
+ * @param offsets The row offsets, one more than the nodes
+ * @param targets The end point of every edge
+ * @param weights The weight of every edge
+ * @param pheros The pheromone level of every edge, or nullptr
+ */
+void Snapshot::write(const std::string& filename, 
+		const std::vector<std::int64_t>& offsets, 
+		const std::vector<std::int32_t>& targets, const std::vector<double>& weights, 
+		const std::vector<double>* pheros)
+{
+	Header header = {};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.byteOrder = ORDER_MARK;
+	header.flags = pheros ? WITH_PHEROMONE : 0;
+	header.nodes = offsets.empty() ? 0 : offsets.size() - 1;
+	header.edges = targets.size();
+
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if(!file)
+		throw std::runtime_error(filename + ": cannot open file");
+
+	const char padding[8] = {};
+	auto put = [&file, &padding](const void* data, size_t size)
+	{
+		file.write(static_cast<const char*>(data), size);
+		file.write(padding, align(size) - size);
+	};
+	put(&header, sizeof(Header));
+	std::int64_t first = 0;
+	put(offsets.empty() ? &first : offsets.data(), 
+			std::max<size_t>(1, offsets.size()) * sizeof(std::int64_t));
+	put(targets.data(), targets.size() * sizeof(std::int32_t));
+	put(weights.data(), weights.size() * sizeof(double));
+	if(pheros)
+		put(pheros->data(), pheros->size() * sizeof(double));
+
+	if(!file)
+		throw std::runtime_error(filename + ": cannot write snapshot");
+}
+
+/**
+ * Returns the number of nodes.
+ *
+ * @return int Number of nodes
+ */
+int Snapshot::nodes() const
+{
+	return static_cast<int>(header.nodes);
+}
+
+/**
+ * Returns the number of edges.
+ *
+ * @return std::int64_t Number of edges
+ */
+std::int64_t Snapshot::edges() const
+{
+	return static_cast<std::int64_t>(header.edges);
+}
+
+/**
+ * Returns the row offsets, where the edges of node n lie in the range 
+ * [offsets[n], offsets[n + 1]).
+ *
+ * @return const std::int64_t* The offsets
+ */
+const std::int64_t* Snapshot::offsets() const
+{
+	return rowOffsets;
+}
+
+/**
+ * Returns the end point of every edge.
+ *
+ * @return const std::int32_t* The targets
+ */
+const std::int32_t* Snapshot::targets() const
+{
+	return edgeTargets;
+}
+
+/**
+ * Returns the weight of every edge.
+ *
+ * @return const double* The weights
+ */
+const double* Snapshot::weights() const
+{
+	return edgeWeights;
+}
+
+/**
+ * Returns the pheromone level of every edge.
+ *
+ * @return const double* The pheromone levels or nullptr if not stored
+ */
+const double* Snapshot::pheros() const
+{
+	return edgePheros;
+}
+
+/**
+ * Rounds a size up to the next eight byte boundary.
+ *
+ * @param size The size
+ * @return size_t The aligned size
+ */
+size_t Snapshot::align(size_t size)
+{
+	return (size + 7) & ~static_cast<size_t>(7);
+}
@@ -0,0 +1,78 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "mappedfile.h"
+
+/**
+ * Versioned binary snapshot of a graph in compressed-sparse-row form, i.e., 
+ * a header followed by the row offsets, the targets, the weights and 
+ * optionally the pheromone level of every edge. The arrays are aligned, so 
+ * they are used in place from the memory-mapped file.
+ */
+class Snapshot
+{
+public:
+	static const std::uint32_t VERSION = 1;
+	explicit Snapshot(const std::string&) noexcept(false);
+	static bool probe(const std::string&);
+	static void write(const std::string&, const std::vector<std::int64_t>&, 
+			const std::vector<std::int32_t>&, const std::vector<double>&, 
+			const std::vector<double>* = nullptr) noexcept(false);
+	int nodes() const;
+	std::int64_t edges() const;
+	const std::int64_t* offsets() const;
+	const std::int32_t* targets() const;
+	const double* weights() const;
+	const double* pheros() const;
+
+private:
+	struct Header
+	{
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t byteOrder;
+		std::uint32_t flags;
+		std::uint32_t reserved;
+		std::uint64_t nodes;
+		std::uint64_t edges;
+	};
+
+	static const std::uint32_t ORDER_MARK = 0x01020304;
+	static const std::uint32_t WITH_PHEROMONE = 1;
+	static size_t align(size_t);
+	MappedFile file;
+	Header header;
+	const std::int64_t* rowOffsets;
+	const std::int32_t* edgeTargets;
+	const double* edgeWeights;
+	const double* edgePheros;
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,68 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include "adaptivesystem.h"
+
+/**
+ * Minimal system that only holds a topology, used for the conversion. The 
+ * nodes without edges are kept and the repeated links dropped, as the 
+ * colonies do when loading the JSON file.
+ */
+class Converter : public AdaptiveSystem
+{
+public:
+	std::vector<int> path(int, int) { return std::vector<int>(); }
+	void clear() { edges.clear(); nodes = 0; }
+	void load(const std::string& filename) { initTopo(filename); dropDuplicates(); }
+
+protected:
+	void reserveNodes(int nodes) { this->nodes = std::max(this->nodes, nodes); }
+	int nodeCount() const { return std::max(nodes, AdaptiveSystem::nodeCount()); }
+
+private:
+	int nodes = 0;
+};
+
+int main(int argc, char *argv[])
+{
+	if(argc != 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <topology.json> <snapshot>" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		Converter converter;
+		converter.load(argv[1]);
+		converter.saveSnapshot(argv[2]);
+	}
+	catch(std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
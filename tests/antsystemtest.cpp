@@ -0,0 +1,164 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <map>
+#include "check.h"
+#include "antsystem.h"
+
+static std::string temporary(const std::string& name)
+{
+	return (std::filesystem::temp_directory_path() / ("acopath-antsystemtest-" + name)).string();
+}
+
+/**
+ * A link listed twice keeps its first weight, since a row holds one edge 
+ * per target.
+ */
+static void repeatedLinks()
+{
+	std::string json = temporary("repeated.json");
+	std::ofstream(json) << "{ \"links\": [ { \"nodes\": [0, 1], \"length\": 5 },"
+			" { \"nodes\": [0, 1], \"length\": 1 }, { \"nodes\": [1, 2], \"length\": 1 } ] }";
+	AntSystem ants(json, 20, 10);
+	ants.seed(1);
+	AntSystem::Result result = ants.query(0, 2);
+	CHECK(result.path == std::vector<int>({0, 1, 2}));
+	CHECK(result.length == 6);
+	CHECK_THROWS(ants.insertEdge(0, 1, 3));
+	std::filesystem::remove(json);
+
+	std::string snap = temporary("repeated.snap");
+	Snapshot::write(snap, {0, 2, 2}, {1, 1}, {4, 2});
+	AntSystem loaded(snap, 20, 10);
+	loaded.seed(1);
+	result = loaded.query(0, 1);
+	CHECK(result.path == std::vector<int>({0, 1}));
+	CHECK(result.length == 4);
+	std::filesystem::remove(snap);
+}
+
+/**
+ * Edges that do not exist are reported without touching the topology.
+ */
+static void missingEdges()
+{
+	AntSystem ants(20, 10);
+	ants.insertEdge(0, 1, 1);
+	ants.insertEdge(1, 2, 1);
+	CHECK(!ants.removeEdge(0, 2));
+	CHECK(!ants.updateEdge(2, 0, 1));
+	CHECK(ants.removeEdge(1, 2));
+	CHECK(ants.path(0, 2).empty());
+	CHECK(ants.path(0, 1) == std::vector<int>({0, 1}));
+}
+
+/**
+ * Negative node IDs are rejected before the topology is touched.
+ */
+static void negativeNodes()
+{
+	AntSystem ants(20, 10);
+	ants.insertEdge(0, 1, 1);
+	CHECK_THROWS(ants.insertEdge(-1, 2, 1));
+	CHECK_THROWS(ants.insertEdge(2, -1, 1));
+	CHECK_THROWS(ants.removeEdge(-1, 0));
+	CHECK_THROWS(ants.updateEdge(0, -1, 1));
+	CHECK(ants.path(0, 1) == std::vector<int>({0, 1}));
+}
+
+/**
+ * A hint is laid once per source and destination, and again once the 
+ * table holding it is evicted.
+ */
+static void hints()
+{
+	AntSystem ants("topology.json", 20, 5);
+	ants.seed(1);
+	ants.setWarmStart(1, 5);
+	std::map<std::pair<int, int>, int> asked;
+	AntSystem::Hint hint = [&](int from, int to)
+	{
+		++asked[{from, to}];
+		return std::vector<int>();
+	};
+	auto count = [&](int from, int to) { return asked[{from, to}]; };
+
+	ants.query(0, 19, hint);
+	ants.query(0, 19, hint);
+	CHECK(count(0, 19) == 1);
+	ants.query(1, 19, hint);
+	CHECK(count(1, 19) == 1);
+	ants.query(0, 18, hint);
+	ants.query(0, 19, hint);
+	CHECK(count(0, 19) == 2);
+	ants.updateEdge(0, 4, 31);
+	ants.query(0, 19, hint);
+	CHECK(count(0, 19) == 3);
+}
+
+/**
+ * With pruning, no tour of a later iteration exceeds the shortest tour of 
+ * the earlier ones, whether walked forwards or joined from two walks.
+ */
+static void pruning()
+{
+	for(bool bidirectional : {false, true})
+	{
+		AntSystem::Strategy strategy;
+		strategy.bidirectional = bidirectional;
+		strategy.pruning = 1;
+		AntSystem::StopCriteria criteria;
+		std::vector<AntSystem::Stats> stats;
+		std::vector<double> lengths;
+		for(int budget : {1, 2})
+		{
+			AntSystem ants("topology.json", 400, 10);
+			ants.seed(3);
+			ants.setStrategy(strategy);
+			criteria.maxIterations = budget;
+			ants.setStopCriteria(criteria);
+			ants.setInstrumentation(true);
+			lengths.push_back(ants.query(0, 8).length);
+			stats.push_back(ants.stats());
+		}
+		long arrived = stats[1].arrived - stats[0].arrived;
+		double total = stats[1].tourLengths - stats[0].tourLengths;
+		CHECK(stats[1].pruned > stats[0].pruned);
+		CHECK(arrived > 0);
+		CHECK(total <= arrived * lengths[0] + 1e-9);
+	}
+}
+
+int main()
+{
+	repeatedLinks();
+	missingEdges();
+	negativeNodes();
+	hints();
+	pruning();
+	return result();
+}
@@ -0,0 +1,95 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <map>
+#include <utility>
+#include "check.h"
+#include "antsystem.h"
+
+typedef std::map<std::pair<int, int>, double> Weights;
+
+/**
+ * Sums the weights along a path, or -1 when it is not a path from the start 
+ * to the end of the pair.
+ */
+static double length(const Weights& weights, const std::vector<int>& path, 
+		const std::pair<int, int>& pair)
+{
+	if(path.size() < 2 || path.front() != pair.first || path.back() != pair.second)
+		return -1;
+	double total = 0;
+	for(unsigned int hop = 1; hop < path.size(); ++hop)
+	{
+		auto edge = weights.find({path[hop - 1], path[hop]});
+		if(edge == weights.end())
+			return -1;
+		total += edge->second;
+	}
+	return total;
+}
+
+/**
+ * Pairs answered in a batch, where the ones sharing a destination share a 
+ * colony, are valid and as short as the same pairs queried one by one, on 
+ * any number of threads. Every destination starts from fresh trails through 
+ * its own table, as a single query does.
+ */
+static void singles()
+{
+	Weights weights;
+	TopologyReader("topology.json").read([](int) { }, [&](int src, int dest, double weight)
+			{
+				weights[{src, dest}] = weight;
+			});
+	std::vector<std::pair<int, int>> pairs = {{0, 19}, {3, 19}, {5, 19}, {0, 13}, 
+			{7, 13}, {19, 0}, {0, 19}};
+	for(int threads : {1, 4})
+	{
+		AntSystem batch("topology.json");
+		batch.seed(1);
+		batch.setThreads(threads);
+		batch.setWarmStart(8, AntSystem::ITERATIONS);
+		std::vector<std::vector<int>> found = batch.paths(pairs);
+		CHECK(found.size() == pairs.size());
+		for(unsigned int index = 0; index < pairs.size() && index < found.size(); ++index)
+		{
+			AntSystem single("topology.json");
+			single.seed(1);
+			double alone = length(weights, single.path(pairs[index].first, 
+					pairs[index].second), pairs[index]);
+			double batched = length(weights, found[index], pairs[index]);
+			CHECK(alone > 0 && batched > 0 && batched <= alone);
+		}
+		CHECK(found[0] == found[6]);
+	}
+
+	AntSystem empty("topology.json");
+	CHECK(empty.paths({}).empty());
+}
+
+int main()
+{
+	singles();
+	return result();
+}
@@ -0,0 +1,98 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include "check.h"
+#include "antsystem.h"
+
+/**
+ * Builds a chain whose every node also leads into three dead ends, which 
+ * ants walking forwards almost never get past but the single predecessor 
+ * of every node leads ants walking backwards straight to the source.
+ */
+static void trapChain(AntSystem& ants, int length)
+{
+	for(int node = 0; node < length; ++node)
+	{
+		ants.insertEdge(node, node + 1, 1);
+		for(int trap = 0; trap < 3; ++trap)
+			ants.insertEdge(node, length + 1 + 3 * node + trap, 1);
+	}
+}
+
+/**
+ * Only backward ants reach the destination of the trap chain, which the 
+ * forward ones never do within a few iterations.
+ */
+static void traps()
+{
+	const int length = 30;
+	for(bool bidirectional : {false, true})
+	{
+		AntSystem ants(20, 10);
+		ants.seed(1);
+		trapChain(ants, length);
+		AntSystem::Strategy strategy;
+		strategy.bidirectional = bidirectional;
+		ants.setStrategy(strategy);
+		ants.setInstrumentation(true);
+
+		AntSystem::Result result = ants.query(0, length);
+		if(bidirectional)
+		{
+			CHECK(result.path.size() == length + 1);
+			CHECK(result.length == length);
+			CHECK(ants.stats().arrived > 0);
+		}
+		else
+		{
+			CHECK(result.path.empty());
+			CHECK(ants.stats().arrived == 0);
+		}
+		CHECK(ants.stats().deadEnds > 0);
+	}
+}
+
+/**
+ * Joined walks are tours of the topology as well, with the shortest path 
+ * from 0 to 19 of length 142 found as by forward ants alone.
+ */
+static void joined()
+{
+	AntSystem ants("topology.json");
+	ants.seed(1);
+	AntSystem::Strategy strategy;
+	strategy.bidirectional = true;
+	ants.setStrategy(strategy);
+	AntSystem::Result result = ants.query(0, 19);
+	CHECK(result.path.size() > 1 && result.path.front() == 0 && result.path.back() == 19);
+	CHECK(result.length == 142);
+}
+
+int main()
+{
+	traps();
+	joined();
+	return result();
+}
@@ -0,0 +1,70 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdlib>
+#include <iostream>
+
+// Reports a failed condition and makes the test fail at exit
+#define CHECK(condition) \
+	do \
+	{ \
+		if(!(condition)) \
+		{ \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": " << #condition  \
+					<< " failed" << std::endl; \
+			failures() = true; \
+		} \
+	} while(false)
+
+// Expects a statement to throw, e.g., upon malformed input
+#define CHECK_THROWS(statement) \
+	do \
+	{ \
+		bool thrown = false; \
+		try \
+		{ \
+			statement; \
+		} \
+		catch(std::exception&) \
+		{ \
+			thrown = true; \
+		} \
+		CHECK(thrown && #statement); \
+	} while(false)
+
+inline bool& failures()
+{
+	static bool failed = false;
+	return failed;
+}
+
+inline int result()
+{
+	return failures() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+#endif // CHECK_H
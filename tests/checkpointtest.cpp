@@ -0,0 +1,79 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include "check.h"
+#include "antsystem.h"
+
+static std::string contents(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/**
+ * A restored checkpoint holds every slot and saves back to the same bytes.
+ */
+static void roundTrip(const std::string& first, const std::string& second)
+{
+	AntSystem trained("topology.json", 20, 10);
+	trained.seed(1);
+	trained.query(0, 19);
+	trained.savePheromone(first);
+
+	AntSystem restored("topology.json", 20, 10);
+	CHECK(restored.restorePheromone(first) == 98);
+	restored.savePheromone(second);
+	CHECK(contents(first) == contents(second));
+}
+
+/**
+ * Files whose size does not match their number of records are rejected.
+ */
+static void mismatches(const std::string& saved, const std::string& broken)
+{
+	std::string bytes = contents(saved);
+	AntSystem aco("topology.json", 20, 10);
+	for(std::string changed : {bytes.substr(0, bytes.size() - 1), 
+			bytes.substr(0, bytes.size() - 16), bytes + std::string(16, '\0'), 
+			bytes.substr(0, 8)})
+	{
+		std::ofstream(broken, std::ios::binary) << changed;
+		CHECK_THROWS(aco.restorePheromone(broken));
+	}
+}
+
+int main()
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path();
+	std::string first = (directory / "acopath-checkpointtest-1.bin").string();
+	std::string second = (directory / "acopath-checkpointtest-2.bin").string();
+	roundTrip(first, second);
+	mismatches(first, second);
+	std::filesystem::remove(first);
+	std::filesystem::remove(second);
+	return result();
+}
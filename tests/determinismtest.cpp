@@ -0,0 +1,102 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include "check.h"
+#include "antsystem.h"
+
+static std::string contents(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/**
+ * A fixed seed gives the same paths, iterations and pheromone under any 
+ * number of threads, for every kind of walk and update.
+ */
+static void threads()
+{
+	std::string filename = (std::filesystem::temp_directory_path() 
+			/ "acopath-determinismtest.bin").string();
+	std::vector<AntSystem::Strategy> strategies(4);
+	strategies[1].bidirectional = true;
+	strategies[2].rule = AntSystem::Rule::COLONY_SYSTEM;
+	strategies[3].landmarks = 4;
+	strategies[3].pruning = 1.5;
+	for(auto& strategy : strategies)
+	{
+		std::vector<AntSystem::Result> results;
+		std::vector<std::string> levels;
+		for(int threads : {1, 2, 4})
+		{
+			AntSystem ants("topology.json", 100, 20);
+			ants.seed(7);
+			ants.setThreads(threads);
+			ants.setStrategy(strategy);
+			results.push_back(ants.query(0, 19));
+			ants.query(3, 13);
+			ants.savePheromone(filename);
+			levels.push_back(contents(filename));
+		}
+		CHECK(!results[0].path.empty());
+		for(unsigned int run = 1; run < results.size(); ++run)
+		{
+			CHECK(results[run].path == results[0].path);
+			CHECK(results[run].length == results[0].length);
+			CHECK(results[run].iterations == results[0].iterations);
+			CHECK(levels[run] == levels[0]);
+		}
+	}
+	std::filesystem::remove(filename);
+}
+
+/**
+ * Seeding again repeats the same walks upon a fresh instance, while 
+ * another seed draws other walks.
+ */
+static void reseeding()
+{
+	std::vector<double> lengths;
+	for(std::uint64_t seed : {7, 7, 8})
+	{
+		AntSystem ants("topology.json", 200, 3);
+		ants.seed(seed);
+		ants.setInstrumentation(true);
+		ants.query(0, 8);
+		lengths.push_back(ants.stats().tourLengths);
+	}
+	CHECK(lengths[0] > 0);
+	CHECK(lengths[0] == lengths[1]);
+	CHECK(lengths[0] != lengths[2]);
+}
+
+int main()
+{
+	threads();
+	reseeding();
+	return result();
+}
@@ -0,0 +1,146 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include "check.h"
+#include "deviceantsystem.h"
+
+static std::string contents(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/**
+ * The colonies find the shortest paths of the topology, of lengths 142 from 
+ * 0 to 19 and 62 from 0 to 8, with the same paths upon the same seed, and 
+ * without a device exactly as the Ant System does.
+ */
+static void shortest()
+{
+	std::string filename = (std::filesystem::temp_directory_path() 
+			/ "acopath-deviceantsystemtest.bin").string();
+	for(auto [dest, length] : {std::pair(19, 142.0), std::pair(8, 62.0)})
+	{
+		std::vector<std::string> levels;
+		std::vector<AntSystem::Result> results;
+		for(int run = 0; run < 2; ++run)
+		{
+			DeviceAntSystem ants("topology.json");
+			ants.seed(1);
+			results.push_back(ants.query(0, dest));
+			ants.savePheromone(filename);
+			levels.push_back(contents(filename));
+			CHECK(ants.deviceName().empty() == !ants.onDevice());
+			if(run == 0 && !ants.onDevice())
+			{
+				AntSystem cpu("topology.json");
+				cpu.seed(1);
+				AntSystem::Result expected = cpu.query(0, dest);
+				cpu.savePheromone(filename);
+				CHECK(results[0].path == expected.path);
+				CHECK(results[0].iterations == expected.iterations);
+				CHECK(levels[0] == contents(filename));
+			}
+		}
+		std::filesystem::remove(filename);
+		CHECK(results[0].path.size() > 1 && results[0].path.front() == 0 
+				&& results[0].path.back() == dest);
+		CHECK(results[0].length == length);
+		CHECK(results[0].path == results[1].path);
+		CHECK(levels[0] == levels[1]);
+	}
+}
+
+/**
+ * Rules and walks that the kernels do not cover run upon the CPU, with 
+ * the same outcome as the Ant System's.
+ */
+static void fallback()
+{
+	std::vector<AntSystem::Strategy> strategies(3);
+	strategies[0].rule = AntSystem::Rule::COLONY_SYSTEM;
+	strategies[1].rule = AntSystem::Rule::MAX_MIN;
+	strategies[2].bidirectional = true;
+	for(auto& strategy : strategies)
+	{
+		DeviceAntSystem device("topology.json", 100, 20);
+		AntSystem cpu("topology.json", 100, 20);
+		device.seed(5);
+		cpu.seed(5);
+		device.setStrategy(strategy);
+		cpu.setStrategy(strategy);
+		AntSystem::Result found = device.query(0, 19);
+		AntSystem::Result expected = cpu.query(0, 19);
+		CHECK(found.path == expected.path);
+		CHECK(found.length == expected.length);
+	}
+}
+
+/**
+ * The elitist rule, landmarks with pruning, batches and counters run as 
+ * upon the CPU, and stop by the same criteria.
+ */
+static void features()
+{
+	AntSystem::Strategy strategy;
+	strategy.rule = AntSystem::Rule::ELITIST;
+	strategy.elitism = 5;
+	strategy.landmarks = 4;
+	strategy.pruning = 1.5;
+	DeviceAntSystem ants("topology.json", 100, 40);
+	ants.seed(1);
+	ants.setStrategy(strategy);
+	ants.setInstrumentation(true);
+	AntSystem::StopCriteria criteria;
+	criteria.stagnation = 10;
+	ants.setStopCriteria(criteria);
+	AntSystem::Result result = ants.query(0, 19);
+	CHECK(result.path.size() > 1 && result.path.front() == 0 && result.path.back() == 19);
+	CHECK(result.reason == AntSystem::StopReason::STAGNATION 
+			|| result.iterations == 40);
+	const AntSystem::Stats& stats = ants.stats();
+	CHECK(stats.iterations == result.iterations);
+	CHECK(stats.arrived + stats.cycles + stats.deadEnds + stats.pruned 
+			== 100L * result.iterations);
+	CHECK((int)stats.trajectory.size() == result.iterations);
+
+	std::vector<std::pair<int, int>> pairs = {{0, 19}, {3, 19}, {0, 13}};
+	std::vector<std::vector<int>> found = ants.paths(pairs);
+	CHECK(found.size() == pairs.size());
+	for(unsigned int index = 0; index < pairs.size() && index < found.size(); ++index)
+		CHECK(found[index].size() > 1 && found[index].front() == pairs[index].first 
+				&& found[index].back() == pairs[index].second);
+}
+
+int main()
+{
+	shortest();
+	fallback();
+	features();
+	return result();
+}
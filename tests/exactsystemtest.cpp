@@ -0,0 +1,190 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <queue>
+#include <random>
+#include "check.h"
+#include "exactsystem.h"
+#include "hybridsystem.h"
+
+typedef std::map<std::pair<int, int>, double> Weights;
+
+/**
+ * Textbook Dijkstra over the edge map, returning the distances from start.
+ */
+static std::vector<double> dijkstra(const Weights& weights, int nodes, int start)
+{
+	std::vector<std::vector<std::pair<int, double>>> rows(nodes);
+	for(auto& [ends, weight] : weights)
+		rows[ends.first].push_back({ends.second, weight});
+	std::vector<double> dists(nodes, std::numeric_limits<double>::infinity());
+	typedef std::pair<double, int> Entry;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+	dists[start] = 0;
+	queue.push({0, start});
+	while(!queue.empty())
+	{
+		auto [dist, node] = queue.top();
+		queue.pop();
+		if(dist > dists[node])
+			continue;
+		for(auto& [dest, weight] : rows[node])
+			if(dist + weight < dists[dest])
+			{
+				dists[dest] = dist + weight;
+				queue.push({dists[dest], dest});
+			}
+	}
+	return dists;
+}
+
+/**
+ * Every answer matches the reference distance and follows existing edges 
+ * that add up to it.
+ */
+static void compare(ExactSystem& exact, const Weights& weights, int nodes)
+{
+	for(int start = 0; start < nodes; ++start)
+	{
+		std::vector<double> dists = dijkstra(weights, nodes, start);
+		for(int end = 0; end < nodes; ++end)
+		{
+			if(end == start)
+				continue;
+			ExactSystem::Result result = exact.query(start, end);
+			if(std::isinf(dists[end]))
+			{
+				CHECK(result.path.empty());
+				continue;
+			}
+			CHECK(!result.path.empty() && result.path.front() == start && result.path.back() == end);
+			CHECK(std::abs(result.length - dists[end]) < 1e-9);
+			double length = 0;
+			for(std::size_t hop = 1; hop < result.path.size(); ++hop)
+			{
+				auto edge = weights.find({result.path[hop - 1], result.path[hop]});
+				CHECK(edge != weights.end());
+				if(edge != weights.end())
+					length += edge->second;
+			}
+			CHECK(std::abs(length - result.length) < 1e-9);
+		}
+	}
+}
+
+/**
+ * Random sparse graphs, checked again after updates and removals, whose 
+ * edges are owned or belong to a colony.
+ */
+static void randomGraphs(bool guided, bool viewed)
+{
+	std::mt19937 random(7);
+	const int nodes = 40;
+	for(int round = 0; round < 5; ++round)
+	{
+		// Node positions on a line give a consistent bound when no edge is 
+		// shorter than the distance it covers
+		std::vector<double> positions(nodes);
+		for(auto& position : positions)
+			position = random() % 50;
+		auto bound = [&](int from, int to) { return std::abs(positions[from] - positions[to]); };
+
+		AntSystem colony(1, 1);
+		ExactSystem own, view(colony);
+		AdaptiveSystem& owner = viewed ? static_cast<AdaptiveSystem&>(colony) : own;
+		ExactSystem& exact = viewed ? view : own;
+		if(guided)
+			exact.setHeuristic(bound);
+		Weights weights;
+		while(weights.size() < 150)
+		{
+			int src = random() % nodes, dest = random() % nodes;
+			if(src == dest || weights.count({src, dest}))
+				continue;
+			double weight = bound(src, dest) + 1 + random() % 20;
+			owner.insertEdge(src, dest, weight);
+			weights[{src, dest}] = weight;
+		}
+		compare(exact, weights, nodes);
+
+		for(int change = 0; change < 30; ++change)
+		{
+			auto edge = std::next(weights.begin(), random() % weights.size());
+			auto [src, dest] = edge->first;
+			if(change % 2)
+			{
+				CHECK(owner.removeEdge(src, dest));
+				weights.erase(edge);
+			}
+			else
+			{
+				edge->second = bound(src, dest) + 1 + random() % 20;
+				CHECK(owner.updateEdge(src, dest, edge->second));
+			}
+		}
+		CHECK(!owner.removeEdge(0, 0));
+		compare(exact, weights, nodes);
+	}
+}
+
+/**
+ * A link listed twice keeps its first weight, as within the colonies, and 
+ * a colony's topology is only changed through the colony.
+ */
+static void repeatedLinks()
+{
+	std::string json = (std::filesystem::temp_directory_path() 
+			/ "acopath-exactsystemtest-repeated.json").string();
+	std::ofstream(json) << "{ \"links\": [ { \"nodes\": [0, 1], \"length\": 9 },"
+			" { \"nodes\": [0, 1], \"length\": 5 } ] }";
+	ExactSystem exact(json);
+	CHECK(exact.query(0, 1).length == 9);
+	CHECK_THROWS(exact.insertEdge(0, 1, 1));
+
+	HybridSystem hybrid(json, 5, 5);
+	CHECK(hybrid.query(0, 1).length == 9);
+	AntSystem colony(json, 5, 5);
+	ExactSystem view(colony);
+	CHECK(view.query(0, 1).length == 9);
+	CHECK_THROWS(view.insertEdge(1, 0, 1));
+	CHECK_THROWS(view.updateEdge(0, 1, 1));
+	colony.updateEdge(0, 1, 2);
+	CHECK(view.query(0, 1).length == 2);
+	std::filesystem::remove(json);
+}
+
+int main()
+{
+	randomGraphs(false, false);
+	randomGraphs(true, false);
+	randomGraphs(false, true);
+	randomGraphs(true, true);
+	repeatedLinks();
+	return result();
+}
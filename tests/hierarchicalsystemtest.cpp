@@ -0,0 +1,55 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <filesystem>
+#include <fstream>
+#include "check.h"
+#include "hierarchicalsystem.h"
+
+/**
+ * A link listed twice is kept once within the partitions and the coarse 
+ * graph, as their colonies reject repeated edges.
+ */
+static void repeatedLinks()
+{
+	std::string json = (std::filesystem::temp_directory_path() 
+			/ "acopath-hierarchicalsystemtest-repeated.json").string();
+	std::ofstream(json) << "{ \"links\": [ { \"nodes\": [0, 1], \"length\": 1 },"
+			" { \"nodes\": [0, 1], \"length\": 1 }, { \"nodes\": [1, 2], \"length\": 1 },"
+			" { \"nodes\": [2, 3], \"length\": 1 }, { \"nodes\": [2, 3], \"length\": 4 } ] }";
+	for(int partSize : {2, 256})
+	{
+		HierarchicalSystem hierarchy(json, partSize, 20, 10);
+		hierarchy.seed(1);
+		CHECK(hierarchy.path(0, 3) == std::vector<int>({0, 1, 2, 3}));
+		CHECK_THROWS(hierarchy.insertEdge(1, 2, 1));
+	}
+	std::filesystem::remove(json);
+}
+
+int main()
+{
+	repeatedLinks();
+	return result();
+}
@@ -0,0 +1,101 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "check.h"
+#include "hybridsystem.h"
+
+/**
+ * A chain whose every node also leads into dead ends, so that a single ant 
+ * almost never reaches the last node, which the exact path then answers.
+ */
+static void failedColony()
+{
+	HybridSystem hybrid(1, 1);
+	hybrid.seed(1);
+	const int length = 30;
+	for(int node = 0; node < length; ++node)
+	{
+		hybrid.insertEdge(node, node + 1, 1);
+		for(int trap = 0; trap < 3; ++trap)
+			hybrid.insertEdge(node, length + 1 + 3 * node + trap, 1);
+	}
+
+	AntSystem::Result result = hybrid.query(0, length);
+	CHECK(hybrid.exactAnswers() == 1);
+	CHECK(result.iterations == 1);
+	CHECK(result.path.size() == length + 1);
+	CHECK(result.length == length);
+	CHECK(hybrid.path(length + 1, 0).empty());
+	CHECK(hybrid.exactAnswers() == 1);
+}
+
+/**
+ * Once an iteration is known to take longer than a tenth of the deadline, 
+ * the colony no longer runs.
+ */
+static void tightDeadline()
+{
+	HybridSystem hybrid("topology.json", 20000, 5);
+	hybrid.seed(1);
+	AntSystem::StopCriteria criteria;
+	criteria.deadline = std::chrono::milliseconds(1);
+	hybrid.setStopCriteria(criteria);
+
+	AntSystem::Result first = hybrid.query(0, 19);
+	CHECK(first.iterations > 0);
+	CHECK(hybrid.exactAnswers() == 0);
+	AntSystem::Result second = hybrid.query(0, 19);
+	CHECK(second.iterations == 0);
+	CHECK(hybrid.exactAnswers() == 1);
+	CHECK(second.path.size() > 1 && second.path.front() == 0 && second.path.back() == 19);
+	CHECK(second.length > 0 && (first.path.empty() || second.length <= first.length));
+}
+
+/**
+ * The colony runs again after some exact answers and measures its time per 
+ * iteration anew, rather than the deadline ruling it out for good.
+ */
+static void probing()
+{
+	HybridSystem hybrid("topology.json", 20000, 5);
+	hybrid.seed(1);
+	AntSystem::StopCriteria criteria;
+	criteria.deadline = std::chrono::milliseconds(1);
+	hybrid.setStopCriteria(criteria);
+
+	int runs = 0;
+	for(int query = 0; query < 200; ++query)
+		if(hybrid.query(0, 19).iterations > 0)
+			++runs;
+	CHECK(runs > 1);
+	CHECK(hybrid.exactAnswers() > 0);
+}
+
+int main()
+{
+	failedColony();
+	tightDeadline();
+	probing();
+	return result();
+}
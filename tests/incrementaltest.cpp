@@ -0,0 +1,109 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <utility>
+#include "check.h"
+#include "antsystem.h"
+
+typedef std::map<std::pair<int, int>, double> Levels;
+
+/**
+ * Reads the pheromone levels of a checkpoint, skipping its 24-byte header 
+ * and then 16 bytes per edge: two 32-bit end points and the level.
+ */
+static Levels levels(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	file.seekg(24);
+	Levels found;
+	char record[16];
+	while(file.read(record, sizeof(record)))
+	{
+		std::int32_t src, dest;
+		double level;
+		std::memcpy(&src, record, sizeof(src));
+		std::memcpy(&dest, record + 4, sizeof(dest));
+		std::memcpy(&level, record + 8, sizeof(level));
+		found[{src, dest}] = level;
+	}
+	return found;
+}
+
+/**
+ * Inserting, updating and removing edges, also when rows move, new nodes 
+ * appear and the edges are compacted, keeps the learned levels of every 
+ * other edge, while new edges start from the initial level.
+ */
+static void trails()
+{
+	std::string filename = (std::filesystem::temp_directory_path() 
+			/ "acopath-incrementaltest.bin").string();
+	AntSystem ants("topology.json");
+	ants.seed(1);
+	ants.query(0, 19);
+	ants.savePheromone(filename);
+	Levels learned = levels(filename);
+	CHECK(learned.count({4, 0}) == 1 && learned.count({0, 4}) == 1);
+
+	ants.insertEdge(0, 19, 500);
+	ants.insertEdge(25, 26, 1);
+	CHECK(ants.updateEdge(0, 4, 31));
+	CHECK(ants.removeEdge(4, 0));
+	ants.savePheromone(filename);
+	Levels changed = levels(filename);
+	CHECK(changed.size() == learned.size() + 1);
+	CHECK(changed[std::pair(0, 19)] == AntSystem::PHERO_QUANTITY);
+	CHECK(changed[std::pair(25, 26)] == AntSystem::PHERO_QUANTITY);
+	CHECK(changed.count({4, 0}) == 0);
+	learned.erase({4, 0});
+	for(auto& [edge, level] : learned)
+		CHECK(changed.count(edge) == 1 && changed[edge] == level);
+
+	// Enough new rows for the index to be compacted while they are inserted
+	for(int node = 30; node < 30 + 2 * AntSystem::COMPACT_SLACK; ++node)
+		ants.insertEdge(node, node + 1, 1);
+	for(int node = 30; node < 30 + 2 * AntSystem::COMPACT_SLACK; ++node)
+		CHECK(ants.removeEdge(node, node + 1));
+	ants.savePheromone(filename);
+	Levels compacted = levels(filename);
+	std::filesystem::remove(filename);
+	CHECK(compacted.size() == changed.size());
+	for(auto& [edge, level] : changed)
+		CHECK(compacted.count(edge) == 1 && compacted[edge] == level);
+
+	AntSystem::Result result = ants.query(0, 19);
+	CHECK(result.path.size() > 1 && result.path.front() == 0 && result.path.back() == 19);
+}
+
+int main()
+{
+	trails();
+	return result();
+}
@@ -0,0 +1,109 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include <string>
+#include "check.h"
+#include "antsystem.h"
+
+/**
+ * Every ant of every iteration of a colony ends in exactly one outcome, 
+ * and the best length after every iteration never grows, ending at the 
+ * length of the query's path.
+ */
+static void counters()
+{
+	const int ants = 50, iterations = 30;
+	AntSystem colony("topology.json", ants, iterations);
+	colony.seed(1);
+	colony.setInstrumentation(true);
+	AntSystem::Result result = colony.query(0, 19);
+	const AntSystem::Stats& stats = colony.stats();
+	CHECK(stats.colonies == 1);
+	CHECK(stats.iterations == result.iterations);
+	CHECK(stats.arrived + stats.cycles + stats.deadEnds + stats.pruned 
+			== (long)ants * result.iterations);
+	CHECK(stats.arrived > 0);
+	CHECK(stats.averageLength() >= result.length);
+	CHECK((int)stats.trajectory.size() == result.iterations);
+	for(unsigned int i = 1; i < stats.trajectory.size(); ++i)
+		CHECK(stats.trajectory[i] <= stats.trajectory[i - 1]);
+	CHECK(!stats.trajectory.empty() && stats.trajectory.back() == result.length);
+
+	colony.query(0, 8);
+	CHECK(stats.colonies == 2);
+	CHECK((int)stats.trajectory.size() <= iterations);
+}
+
+/**
+ * Both exports carry every counter.
+ */
+static void exports()
+{
+	AntSystem colony("topology.json", 20, 5);
+	colony.seed(1);
+	colony.setInstrumentation(true);
+	colony.query(0, 19);
+	std::string json = colony.stats().json();
+	for(const char* key : {"\"colonies\":1", "\"iterations\":", "\"arrived\":", 
+			"\"cycles\":", "\"deadEnds\":", "\"pruned\":", "\"averageLength\":", 
+			"\"construct\":", "\"trajectory\":["})
+		CHECK(json.find(key) != std::string::npos);
+	std::string prometheus = colony.stats().prometheus();
+	for(const char* key : {"acopath_colonies_total 1\n", "acopath_iterations_total ", 
+			"outcome=\"arrived\"", "outcome=\"cycle\"", "outcome=\"dead_end\"", 
+			"outcome=\"pruned\"", "phase=\"construct\"", "acopath_tour_length_average "})
+		CHECK(prometheus.find(key) != std::string::npos);
+}
+
+/**
+ * Nothing is counted while instrumentation is disabled, and resetting the 
+ * statistics zeroes every counter.
+ */
+static void disabled()
+{
+	AntSystem colony("topology.json", 20, 5);
+	colony.seed(1);
+	colony.query(0, 19);
+	CHECK(colony.stats().colonies == 0);
+	CHECK(colony.stats().arrived + colony.stats().cycles + colony.stats().deadEnds == 0);
+
+	colony.setInstrumentation(true);
+	colony.query(0, 19);
+	CHECK(colony.stats().colonies == 1);
+	colony.resetStats();
+	const AntSystem::Stats& stats = colony.stats();
+	CHECK(stats.colonies == 0 && stats.iterations == 0);
+	CHECK(stats.arrived + stats.cycles + stats.deadEnds + stats.pruned == 0);
+	CHECK(stats.tourLengths == 0 && stats.trajectory.empty());
+	CHECK(stats.constructTime.count() == 0 && stats.updateTime.count() == 0);
+}
+
+int main()
+{
+	counters();
+	exports();
+	disabled();
+	return result();
+}
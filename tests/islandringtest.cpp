@@ -0,0 +1,161 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <algorithm>
+#include <future>
+#include "check.h"
+#include "antsystem.h"
+#include "islandring.h"
+
+/**
+ * Decoding an encoding gives back the same tours.
+ */
+static void codec()
+{
+	std::vector<std::vector<int>> tours = {{0, 5, 3, 19}, {}, {7}, 
+			{2147483647, 0, -1, 1 << 30}};
+	CHECK(IslandRing::decode(IslandRing::encode(tours)) == tours);
+	CHECK(IslandRing::decode(IslandRing::encode({})).empty());
+}
+
+/**
+ * Truncated, overlong and oversized encodings are rejected.
+ */
+static void malformed()
+{
+	std::string encoded = IslandRing::encode({{0, 5, 3, 19}});
+	CHECK_THROWS(IslandRing::decode(""));
+	CHECK_THROWS(IslandRing::decode(encoded.substr(0, encoded.size() - 1)));
+	CHECK_THROWS(IslandRing::decode(std::string(11, '\x80')));
+	// More tours, and more nodes of a tour, than bytes left
+	CHECK_THROWS(IslandRing::decode(std::string("\x7e", 1)));
+	CHECK_THROWS(IslandRing::decode(std::string("\x02\x7e\x00", 3)));
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ * Builds a ring of two islands upon the loopback interface.
+ */
+static std::pair<std::unique_ptr<IslandRing>, std::unique_ptr<IslandRing>> ring(int port)
+{
+	auto second = std::async(std::launch::async, [port]
+			{
+				return std::make_unique<IslandRing>(port + 1, "127.0.0.1", port, 
+						std::chrono::seconds(2));
+			});
+	auto first = std::make_unique<IslandRing>(port, "127.0.0.1", port + 1, 
+			std::chrono::seconds(2));
+	return {std::move(first), second.get()};
+}
+
+/**
+ * A message beyond the receiver's capacity breaks the ring instead of 
+ * being allocated.
+ */
+static void capacity(int port)
+{
+	auto [first, second] = ring(port);
+	first->setCapacity(4, 1);
+	std::vector<std::vector<int>> small = {{0, 1, 2, 3}};
+	auto received = std::async(std::launch::async, [&second, &small]
+			{
+				return second->exchange(small);
+			});
+	CHECK(first->exchange(small) == small);
+	CHECK(received.get() == small);
+
+	std::vector<std::vector<int>> large(1, std::vector<int>(1000, 1 << 30));
+	received = std::async(std::launch::async, [&second, &large]
+			{
+				return second->exchange(large);
+			});
+	CHECK(first->exchange(small).empty());
+	CHECK(!first->connected());
+	received.get();
+}
+
+/**
+ * Messages larger than the socket buffers cross each other without either 
+ * island waiting for the other to receive first.
+ */
+static void largeMessages(int port)
+{
+	auto [first, second] = ring(port);
+	std::vector<std::vector<int>> outbound(1, std::vector<int>(1 << 24));
+	for(int node = 0; node < (int)outbound[0].size(); ++node)
+		outbound[0][node] = node;
+	std::vector<std::vector<int>> inbound = outbound;
+	std::reverse(inbound[0].begin(), inbound[0].end());
+	auto received = std::async(std::launch::async, [&second, &inbound]
+			{
+				return second->exchange(inbound);
+			});
+	CHECK(first->exchange(outbound) == inbound);
+	CHECK(received.get() == outbound);
+	CHECK(first->connected() && second->connected());
+}
+
+/**
+ * Colonies that would stop early at different iterations, here by a 
+ * deadline upon colonies of different sizes, still exchange equally often, 
+ * so neither waits for the timeout.
+ */
+static void migration(int port)
+{
+	auto [first, second] = ring(port);
+	auto query = [](IslandRing& island, int ants)
+	{
+		AntSystem aco("topology.json", ants, 100);
+		aco.seed(1);
+		AntSystem::StopCriteria criteria;
+		criteria.stagnation = 3;
+		criteria.deadline = std::chrono::milliseconds(2);
+		aco.setStopCriteria(criteria);
+		aco.setMigration([&island](const std::vector<std::vector<int>>& tours)
+				{
+					return island.exchange(tours);
+				}, 1);
+		for(int dest = 17; dest < 20; ++dest)
+			CHECK(aco.query(0, dest).iterations == 100);
+	};
+	auto other = std::async(std::launch::async, [&] { query(*second, 1000); });
+	query(*first, 10);
+	other.get();
+	CHECK(first->connected() && second->connected());
+}
+#endif
+
+int main()
+{
+	codec();
+	malformed();
+#if defined(__unix__) || defined(__APPLE__)
+	int port = 20000 + static_cast<int>(std::chrono::steady_clock::now()
+			.time_since_epoch().count() % 20000);
+	capacity(port);
+	migration(port + 2);
+	largeMessages(port + 4);
+#endif
+	return result();
+}
@@ -0,0 +1,97 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include <utility>
+#include "check.h"
+#include "antsystem.h"
+
+/**
+ * Landmarks bound the remaining distance of the dead ends of a trap chain 
+ * by infinity, so that no ant enters them, while ants without landmarks 
+ * keep ending in them.
+ */
+static void deadEnds()
+{
+	const int length = 30;
+	for(int landmarks : {0, 4})
+	{
+		AntSystem ants(20, 10);
+		ants.seed(1);
+		for(int node = 0; node < length; ++node)
+		{
+			ants.insertEdge(node, node + 1, 1);
+			for(int trap = 0; trap < 3; ++trap)
+				ants.insertEdge(node, length + 1 + 3 * node + trap, 1);
+		}
+		AntSystem::Strategy strategy;
+		strategy.landmarks = landmarks;
+		ants.setStrategy(strategy);
+		ants.setInstrumentation(true);
+
+		AntSystem::Result result = ants.query(0, length);
+		if(landmarks)
+		{
+			CHECK(result.path.size() == length + 1);
+			CHECK(ants.stats().deadEnds == 0);
+			CHECK(ants.stats().arrived == 20 * 10);
+		}
+		else
+		{
+			CHECK(result.path.empty());
+			CHECK(ants.stats().deadEnds > 0);
+		}
+	}
+}
+
+/**
+ * The bounds of landmarks keep the shortest paths of the topology within 
+ * reach, of lengths 142 from 0 to 19 and 62 from 0 to 8, also once the 
+ * landmarks are rebuilt after a change of the topology.
+ */
+static void shortest()
+{
+	for(auto [dest, length] : {std::pair(19, 142), std::pair(8, 62)})
+	{
+		AntSystem ants("topology.json");
+		ants.seed(1);
+		AntSystem::Strategy strategy;
+		strategy.landmarks = 4;
+		ants.setStrategy(strategy);
+		AntSystem::Result result = ants.query(0, dest);
+		CHECK(result.path.size() > 1 && result.path.front() == 0 && result.path.back() == dest);
+		CHECK(result.length == length);
+
+		ants.insertEdge(0, dest, 10);
+		result = ants.query(0, dest);
+		CHECK(result.path.size() == 2 && result.length == 10);
+	}
+}
+
+int main()
+{
+	deadEnds();
+	shortest();
+	return result();
+}
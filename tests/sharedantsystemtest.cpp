@@ -0,0 +1,65 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <thread>
+#include "check.h"
+#include "sharedantsystem.h"
+
+/**
+ * Batches from many threads at once share the pool of one instance, where 
+ * a batch that finds the pool busy runs on its own thread.
+ */
+static void concurrentBatches()
+{
+	SharedAntSystem aco("topology.json", 20, 10);
+	aco.setThreads(4);
+	std::vector<std::pair<int, int>> pairs;
+	for(int dest = 1; dest < 20; ++dest)
+		pairs.emplace_back(0, dest);
+
+	std::vector<std::vector<std::vector<int>>> found(4);
+	std::vector<std::thread> callers;
+	for(int caller = 0; caller < 4; ++caller)
+		callers.emplace_back([&aco, &pairs, &found, caller]
+				{
+					for(int round = 0; round < 5; ++round)
+						found[caller] = aco.paths(pairs);
+				});
+	for(auto& caller : callers)
+		caller.join();
+
+	for(auto& paths : found)
+	{
+		CHECK(paths.size() == pairs.size());
+		for(unsigned int index = 0; index < paths.size() && index < pairs.size(); ++index)
+			CHECK(paths[index].empty() || (paths[index].front() == pairs[index].first
+					&& paths[index].back() == pairs[index].second));
+	}
+}
+
+int main()
+{
+	concurrentBatches();
+	return result();
+}
@@ -0,0 +1,172 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <filesystem>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include "check.h"
+#include "antsystem.h"
+#include "exactsystem.h"
+
+static std::string temporary(const std::string& name)
+{
+	return (std::filesystem::temp_directory_path() / ("acopath-snapshottest-" + name)).string();
+}
+
+static std::string contents(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/**
+ * The arrays written are mapped back unchanged.
+ */
+static void arrays()
+{
+	std::string filename = temporary("arrays.snap");
+	std::vector<std::int64_t> offsets = {0, 2, 2, 3, 3};
+	std::vector<std::int32_t> targets = {1, 2, 0};
+	std::vector<double> weights = {1.5, 2, 3}, pheros = {4, 5, 6};
+	Snapshot::write(filename, offsets, targets, weights, &pheros);
+
+	CHECK(Snapshot::probe(filename));
+	Snapshot snapshot(filename);
+	CHECK(snapshot.nodes() == 4);
+	CHECK(snapshot.edges() == 3);
+	CHECK(std::equal(offsets.begin(), offsets.end(), snapshot.offsets()));
+	CHECK(std::equal(targets.begin(), targets.end(), snapshot.targets()));
+	CHECK(std::equal(weights.begin(), weights.end(), snapshot.weights()));
+	CHECK(snapshot.pheros() && std::equal(pheros.begin(), pheros.end(), snapshot.pheros()));
+	std::filesystem::remove(filename);
+}
+
+/**
+ * Truncated, foreign and inconsistent files are rejected.
+ */
+static void malformed()
+{
+	std::string filename = temporary("valid.snap"), broken = temporary("broken.snap");
+	Snapshot::write(filename, {0, 1, 2}, {1, 0}, {1, 1});
+	std::string bytes = contents(filename);
+	auto rejects = [&broken](const std::string& changed)
+	{
+		std::ofstream(broken, std::ios::binary) << changed;
+		CHECK_THROWS(Snapshot snapshot(broken));
+	};
+
+	rejects(bytes.substr(0, bytes.size() - 1));
+	rejects(bytes.substr(0, 16));
+	std::string foreign = bytes;
+	foreign[0] ^= 1;
+	rejects(foreign);
+	// The second target, past the offsets, points beyond the nodes
+	std::string outside = bytes;
+	std::int32_t target = 7;
+	std::memcpy(&outside[bytes.size() - 2 * sizeof(double) - 8 + 4], &target, sizeof(target));
+	rejects(outside);
+	// The offset of the last row exceeds the number of edges
+	std::string descending = bytes;
+	std::int64_t offset = 3;
+	std::memcpy(&descending[56], &offset, sizeof(offset));
+	rejects(descending);
+	std::filesystem::remove(filename);
+	std::filesystem::remove(broken);
+}
+
+/**
+ * A loaded snapshot saves back to the same bytes, pheromone included, and 
+ * answers as the topology it came from.
+ */
+static void antSystem()
+{
+	std::string first = temporary("first.snap"), second = temporary("second.snap");
+	AntSystem original("topology.json", 20, 10);
+	original.seed(1);
+	original.query(0, 19);
+	original.saveSnapshot(first);
+
+	AntSystem loaded(first, 20, 10);
+	loaded.saveSnapshot(second);
+	CHECK(contents(first) == contents(second));
+	original.seed(2);
+	loaded.seed(2);
+	CHECK(original.path(3, 17) == loaded.path(3, 17));
+	loaded.insertEdge(19, 0, 5);
+	CHECK(loaded.removeEdge(19, 0));
+	std::filesystem::remove(first);
+	std::filesystem::remove(second);
+}
+
+/**
+ * Nodes without edges at the end of the topology are kept.
+ */
+static void isolatedNodes()
+{
+	std::string json = temporary("isolated.json"), first = temporary("isolated.snap"), 
+			second = temporary("isolated2.snap");
+	std::ofstream(json) << "{ \"number_of_nodes\": 5, \"links\": [ { \"nodes\": [0, 1],"
+			" \"length\": 1 } ] }";
+	ExactSystem exact(json);
+	exact.saveSnapshot(first);
+	CHECK(Snapshot(first).nodes() == 5);
+
+	AntSystem loaded(first);
+	loaded.saveSnapshot(second);
+	CHECK(Snapshot(second).nodes() == 5);
+	for(auto& filename : {json, first, second})
+		std::filesystem::remove(filename);
+}
+
+/**
+ * The conversion tool keeps the nodes without edges and drops repeated 
+ * links.
+ */
+static void tool()
+{
+	std::string json = temporary("tool.json"), snap = temporary("tool.snap");
+	std::ofstream(json) << "{ \"number_of_nodes\": 5, \"links\": [ { \"nodes\": [0, 1],"
+			" \"length\": 1 }, { \"nodes\": [0, 1], \"length\": 2 } ] }";
+	std::string command = std::string("\"") + SNAPSHOT_TOOL + "\" \"" + json + "\" \"" 
+			+ snap + "\"";
+	CHECK(std::system(command.c_str()) == 0);
+	Snapshot snapshot(snap);
+	CHECK(snapshot.nodes() == 5);
+	CHECK(snapshot.edges() == 1);
+	CHECK(snapshot.weights()[0] == 1);
+	for(auto& filename : {json, snap})
+		std::filesystem::remove(filename);
+}
+
+int main()
+{
+	arrays();
+	malformed();
+	antSystem();
+	isolatedNodes();
+	tool();
+	return result();
+}
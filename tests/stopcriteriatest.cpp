@@ -0,0 +1,80 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "check.h"
+#include "antsystem.h"
+
+static AntSystem::Result run(const AntSystem::StopCriteria& criteria, int ants = 0, 
+		int iterations = 0)
+{
+	AntSystem aco("topology.json", ants, iterations);
+	aco.seed(1);
+	aco.setStopCriteria(criteria);
+	return aco.query(0, 19);
+}
+
+/**
+ * Every criterion stops the query before its budget and reports itself, 
+ * while no criterion runs the whole budget.
+ */
+static void criteria()
+{
+	AntSystem::StopCriteria none;
+	AntSystem::Result full = run(none);
+	CHECK(full.iterations == AntSystem::ITERATIONS);
+	CHECK(full.reason == AntSystem::StopReason::ITERATIONS);
+
+	AntSystem::StopCriteria stagnation;
+	stagnation.stagnation = 5;
+	AntSystem::Result stagnant = run(stagnation);
+	CHECK(stagnant.reason == AntSystem::StopReason::STAGNATION);
+	CHECK(stagnant.iterations >= 5 && stagnant.iterations < AntSystem::ITERATIONS);
+
+	AntSystem::StopCriteria entropy;
+	entropy.entropy = 0.2;
+	AntSystem::Result converged = run(entropy);
+	CHECK(converged.reason == AntSystem::StopReason::ENTROPY);
+	CHECK(converged.iterations < AntSystem::ITERATIONS);
+	CHECK(converged.length == full.length);
+
+	AntSystem::StopCriteria deadline;
+	deadline.deadline = std::chrono::milliseconds(5);
+	auto began = std::chrono::steady_clock::now();
+	AntSystem::Result late = run(deadline, 5000, 100000);
+	CHECK(late.reason == AntSystem::StopReason::DEADLINE);
+	CHECK(late.iterations < 100000);
+	CHECK(std::chrono::steady_clock::now() - began < std::chrono::seconds(5));
+
+	AntSystem::StopCriteria cap;
+	cap.maxIterations = 7;
+	AntSystem::Result capped = run(cap);
+	CHECK(capped.iterations == 7);
+	CHECK(capped.reason == AntSystem::StopReason::ITERATIONS);
+}
+
+int main()
+{
+	criteria();
+	return result();
+}
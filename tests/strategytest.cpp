@@ -0,0 +1,113 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "check.h"
+#include "antsystem.h"
+
+/**
+ * Reads the pheromone levels of a checkpoint, skipping its 24-byte header 
+ * and then 16 bytes per edge: two 32-bit end points and the level.
+ */
+static std::vector<double> levels(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	file.seekg(24);
+	std::vector<double> found;
+	char record[16];
+	while(file.read(record, sizeof(record)))
+	{
+		double level;
+		std::memcpy(&level, record + 8, sizeof(level));
+		found.push_back(level);
+	}
+	return found;
+}
+
+/**
+ * Every rule of the pheromone update finds the shortest paths of the 
+ * topology, of lengths 142 from 0 to 19 and 62 from 0 to 8.
+ */
+static void rules()
+{
+	for(auto rule : {AntSystem::Rule::ANT_SYSTEM, AntSystem::Rule::ELITIST, 
+			AntSystem::Rule::MAX_MIN, AntSystem::Rule::COLONY_SYSTEM})
+	{
+		AntSystem::Strategy strategy;
+		strategy.rule = rule;
+		if(rule == AntSystem::Rule::ELITIST)
+			strategy.elitism = 5;
+		AntSystem ants("topology.json");
+		ants.seed(1);
+		ants.setStrategy(strategy);
+
+		AntSystem::Result far = ants.query(0, 19);
+		CHECK(far.path.size() > 1 && far.path.front() == 0 && far.path.back() == 19);
+		CHECK(far.length == 142);
+		AntSystem::Result near = ants.query(0, 8);
+		CHECK(near.path.size() > 1 && near.path.front() == 0 && near.path.back() == 8);
+		CHECK(near.length == 62);
+	}
+}
+
+/**
+ * The Max-Min Ant System keeps every level within a fraction of the highest 
+ * one, while the Ant System lets unused edges decay far below it.
+ */
+static void bounds()
+{
+	std::string filename = (std::filesystem::temp_directory_path() 
+			/ "acopath-strategytest.bin").string();
+	std::vector<double> ratios;
+	for(auto rule : {AntSystem::Rule::ANT_SYSTEM, AntSystem::Rule::MAX_MIN})
+	{
+		AntSystem::Strategy strategy;
+		strategy.rule = rule;
+		AntSystem ants("topology.json");
+		ants.seed(1);
+		ants.setStrategy(strategy);
+		ants.query(0, 19);
+		ants.savePheromone(filename);
+		std::vector<double> found = levels(filename);
+		CHECK(!found.empty());
+		if(found.empty())
+			return;
+		auto [lowest, highest] = std::minmax_element(found.begin(), found.end());
+		ratios.push_back(*lowest / *highest);
+	}
+	std::filesystem::remove(filename);
+	CHECK(ratios[0] < AntSystem::Strategy().minRatio);
+	CHECK(ratios[1] >= AntSystem::Strategy().minRatio * 0.999);
+}
+
+int main()
+{
+	rules();
+	bounds();
+	return result();
+}
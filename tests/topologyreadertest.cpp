@@ -0,0 +1,102 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <filesystem>
+#include <fstream>
+#include <tuple>
+#include <vector>
+#include "check.h"
+#include "topologyreader.h"
+
+struct Parsed
+{
+	int nodes = -1;
+	std::vector<std::tuple<int, int, double>> links;
+};
+
+/**
+ * Parses a topology given as text through a temporary file.
+ *
+ * @param text The file's contents
+ * @return Parsed The number of nodes and the links
+ */
+static Parsed parse(const std::string& text)
+{
+	std::string filename = (std::filesystem::temp_directory_path() 
+			/ "acopath-readertest.json").string();
+	{
+		std::ofstream file(filename, std::ios::binary);
+		file << text;
+	}
+
+	Parsed parsed;
+	TopologyReader reader(filename);
+	reader.read([&parsed](int nodes) { parsed.nodes = nodes; },
+			[&parsed](int src, int dest, double length)
+			{
+				parsed.links.emplace_back(src, dest, length);
+			});
+	std::filesystem::remove(filename);
+	return parsed;
+}
+
+static void wellFormed()
+{
+	Parsed parsed = parse("{ \"name\": \"a \\\"quoted\\\\\\\" name\", \"number_of_nodes\": 3,"
+			" \"links\": [ { \"nodes\": [0, 2], \"length\": 1.5e1 },"
+			" { \"length\": 7, \"nodes\": [2, 1], \"extra\": [true, null] } ] }");
+	CHECK(parsed.nodes == 3);
+	CHECK(parsed.links.size() == 2);
+	CHECK(parsed.links.size() == 2 && parsed.links[0] == std::make_tuple(0, 2, 15.0));
+	CHECK(parsed.links.size() == 2 && parsed.links[1] == std::make_tuple(2, 1, 7.0));
+}
+
+static void truncatedStrings()
+{
+	CHECK_THROWS(parse("{ \"links"));
+	CHECK_THROWS(parse("{ \"links\\"));
+	CHECK_THROWS(parse("{ \"name\": \"abc\\\""));
+	CHECK_THROWS(parse("{ \"links\": [ { \"nodes\": [0, 1], \"length\": 1 }"));
+	CHECK_THROWS(parse(""));
+}
+
+static void badNodes()
+{
+	CHECK_THROWS(parse("{ \"links\": [ { \"nodes\": [-1, 1], \"length\": 1 } ] }"));
+	CHECK_THROWS(parse("{ \"links\": [ { \"nodes\": [0, 1.5], \"length\": 1 } ] }"));
+	CHECK_THROWS(parse("{ \"links\": [ { \"nodes\": [0, 1e12], \"length\": 1 } ] }"));
+	CHECK_THROWS(parse("{ \"number_of_nodes\": 2, \"links\": [ { \"nodes\": [0, 2],"
+			" \"length\": 1 } ] }"));
+	CHECK_THROWS(parse("{ \"number_of_nodes\": -3 }"));
+	CHECK(parse("{ \"links\": [ { \"nodes\": [0, 5], \"length\": 1 } ],"
+			" \"number_of_nodes\": 2 }").links.size() == 1);
+}
+
+int main()
+{
+	wellFormed();
+	truncatedStrings();
+	badNodes();
+	return result();
+}
@@ -0,0 +1,80 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "check.h"
+#include "antsystem.h"
+
+/**
+ * A destination queried again resumes from its table with the smaller 
+ * budget, and its cached best tour still competes.
+ */
+static void reuse()
+{
+	AntSystem ants("topology.json", 100, 40);
+	ants.seed(1);
+	ants.setWarmStart(2, 5);
+	AntSystem::Result cold = ants.query(0, 19);
+	AntSystem::Result warm = ants.query(0, 19);
+	CHECK(cold.iterations == 40);
+	CHECK(warm.iterations == 5);
+	CHECK(!warm.path.empty() && warm.length <= cold.length);
+
+	// New weights keep the table, while the cached tour is measured anew
+	ants.updateEdge(0, 4, 1000);
+	ants.updateEdge(4, 0, 1000);
+	AntSystem::Result reweighted = ants.query(0, 19);
+	CHECK(reweighted.iterations == 5);
+	CHECK(!reweighted.path.empty());
+}
+
+/**
+ * The least recently used table is evicted beyond the capacity, and every 
+ * table becomes stale once the layout changes.
+ */
+static void eviction()
+{
+	AntSystem ants("topology.json", 100, 40);
+	ants.seed(1);
+	ants.setWarmStart(2, 5);
+	ants.query(0, 19);
+	ants.query(0, 18);
+	CHECK(ants.query(0, 19).iterations == 5);
+	ants.query(0, 17);
+	CHECK(ants.query(0, 19).iterations == 5);
+	CHECK(ants.query(0, 18).iterations == 40);
+
+	ants.insertEdge(0, 19, 500);
+	CHECK(ants.query(0, 19).iterations == 40);
+	CHECK(ants.query(0, 19).iterations == 5);
+
+	ants.setWarmStart(0, 5);
+	CHECK(ants.query(0, 19).iterations == 40);
+}
+
+int main()
+{
+	reuse();
+	eviction();
+	return result();
+}
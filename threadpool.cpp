@@ -0,0 +1,112 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threadpool.h"
+
+/**
+ * Constructor spawning the worker threads. The calling thread acts as 
+ * the first worker, so one thread less is actually spawned.
+ *
+ * @param size Total number of workers
+ */
+ThreadPool::ThreadPool(int size) : job(nullptr), generation(0), pending(0), 
+		stop(false)
+{
+	for(int worker = 1; worker < size; ++worker)
+		workers.emplace_back(&ThreadPool::work, this, worker);
+}
+
+/**
+ * Destructor that stops and joins all workers.
+ */
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		stop = true;
+	}
+	wake.notify_all();
+	for(auto& worker : workers)
+		worker.join();
+}
+
+/**
+ * Returns the number of workers, including the calling thread.
+ *
+ * @return int Number of workers
+ */
+int ThreadPool::size() const
+{
+	return static_cast<int>(workers.size()) + 1;
+}
+
+/**
+ * Executes the job once on every worker and blocks until all are finished.
+ *
+ * @param task Job receiving the index of the worker that executes it
+ */
+void ThreadPool::run(const std::function<void(int)>& task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		job = &task;
+		pending = static_cast<int>(workers.size());
+		++generation;
+	}
+	wake.notify_all();
+
+	// The calling thread takes the first share of the work
+	task(0);
+
+	std::unique_lock<std::mutex> lock(mtx);
+	done.wait(lock, [this] { return pending == 0; });
+	job = nullptr;
+}
+
+/**
+ * Loop of each spawned worker waiting for jobs.
+ *
+ * @param worker The index of this worker
+ */
+void ThreadPool::work(int worker)
+{
+	long int seen = 0;
+	for(;;)
+	{
+		const std::function<void(int)>* task;
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			wake.wait(lock, [this, seen] { return stop || generation != seen; });
+			if(stop)
+				return;
+			seen = generation;
+			task = job;
+		}
+
+		(*task)(worker);
+
+		std::lock_guard<std::mutex> lock(mtx);
+		if(--pending == 0)
+			done.notify_one();
+	}
+}
@@ -0,0 +1,318 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cmath>
+#include <cctype>
+#include <cstdint>
+#include <limits>
+#include "topologyreader.h"
+
+/**
+ * Constructor that maps the file in memory.
+ *
+ * @param filename JSON-formatted file containing the topology representation
+ */
+TopologyReader::TopologyReader(const std::string& filename) : filename(filename), 
+		file(filename), data(file.data()), pos(data), end(data + file.size()), nodes(-1) { }
+
+/**
+ * Parses the topology in a single pass, reporting the number of nodes and 
+ * every link as soon as they are met. Unknown keys are skipped, while node 
+ * IDs that are negative, fractional or not below 'number_of_nodes', when 
+ * it comes first, are rejected.
+ *
+ * @param onNodes Receives the value of 'number_of_nodes'
+ * @param onLink Receives the source, destination and length of each link
+ */
+void TopologyReader::read(const std::function<void(int)>& onNodes, 
+		const std::function<void(int, int, double)>& onLink)
+{
+	pos = data;
+	nodes = -1;
+	expect('{');
+	if(next('}'))
+		return;
+
+	do
+	{
+		std::string_view key = readString();
+		expect(':');
+		if(key == "number_of_nodes")
+		{
+			nodes = -1;
+			nodes = readNode();
+			onNodes(nodes);
+		}
+		else if(key == "links")
+			readLinks(onLink);
+		else
+			skipValue();
+	}
+	while(next(','));
+	expect('}');
+}
+
+/**
+ * Parses the array of links.
+ *
+ * @param onLink Receives the source, destination and length of each link
+ */
+void TopologyReader::readLinks(const std::function<void(int, int, double)>& onLink)
+{
+	expect('[');
+	if(next(']'))
+		return;
+
+	do
+		readLink(onLink);
+	while(next(','));
+	expect(']');
+}
+
+/**
+ * Parses a single link object.
+ *
+ * @param onLink Receives the source, destination and length of the link
+ */
+void TopologyReader::readLink(const std::function<void(int, int, double)>& onLink)
+{
+	int src = 0; int dest = 0; double length = 0;
+	expect('{');
+	if(!next('}'))
+	{
+		do
+		{
+			std::string_view key = readString();
+			expect(':');
+			if(key == "nodes")
+			{
+				expect('[');
+				if(!next(']'))
+				{
+					int index = 0;
+					do
+					{
+						if(index == 0)
+							src = readNode();
+						else if(index == 1)
+							dest = readNode();
+						else
+							skipValue();
+						++index;
+					}
+					while(next(','));
+					expect(']');
+				}
+			}
+			else if(key == "length")
+				length = readNumber();
+			else
+				skipValue();
+		}
+		while(next(','));
+		expect('}');
+	}
+
+	onLink(src, dest, length);
+}
+
+/**
+ * Skips any JSON value.
+ */
+void TopologyReader::skipValue()
+{
+	skipSpace();
+	if(pos == end)
+		fail();
+
+	switch(*pos)
+	{
+	case '{':
+		++pos;
+		if(next('}'))
+			return;
+		do
+		{
+			readString();
+			expect(':');
+			skipValue();
+		}
+		while(next(','));
+		expect('}');
+		return;
+	case '[':
+		++pos;
+		if(next(']'))
+			return;
+		do
+			skipValue();
+		while(next(','));
+		expect(']');
+		return;
+	case '"':
+		readString();
+		return;
+	case 't': case 'f': case 'n':
+		while(pos != end && std::isalpha(static_cast<unsigned char>(*pos)))
+			++pos;
+		return;
+	default:
+		readNumber();
+	}
+}
+
+/**
+ * Parses a string, without decoding escape sequences.
+ *
+ * @return std::string_view The raw characters between the quotes
+ */
+std::string_view TopologyReader::readString()
+{
+	expect('"');
+	const char* first = pos;
+	while(pos < end && *pos != '"')
+	{
+		// An escape needs the character after the backslash
+		if(*pos == '\\' && end - pos < 2)
+			fail();
+		pos += (*pos == '\\') ? 2 : 1;
+	}
+	if(pos >= end)
+		fail();
+
+	return std::string_view(first, pos++ - first);
+}
+
+/**
+ * Parses a number.
+ *
+ * @return double The value
+ */
+double TopologyReader::readNumber()
+{
+	skipSpace();
+	bool negative = next('-');
+	std::uint64_t mantissa = 0;
+	int exponent = 0;
+	int digits = 0;
+	for(; pos != end && *pos >= '0' && *pos <= '9'; ++pos, ++digits)
+		if(mantissa < UINT64_MAX / 10)
+			mantissa = mantissa * 10 + (*pos - '0');
+		else
+			++exponent;
+	if(pos != end && *pos == '.')
+		for(++pos; pos != end && *pos >= '0' && *pos <= '9'; ++pos, ++digits)
+			if(mantissa < UINT64_MAX / 10)
+			{
+				mantissa = mantissa * 10 + (*pos - '0');
+				--exponent;
+			}
+	if(!digits)
+		fail();
+
+	if(pos != end && (*pos == 'e' || *pos == 'E'))
+	{
+		++pos;
+		bool below = next('-');
+		if(!below)
+			next('+');
+		int power = 0;
+		for(; pos != end && *pos >= '0' && *pos <= '9'; ++pos)
+			power = power * 10 + (*pos - '0');
+		exponent += below ? -power : power;
+	}
+
+	double value = static_cast<double>(mantissa);
+	if(exponent)
+		value *= std::pow(10.0, exponent);
+
+	return negative ? -value : value;
+}
+
+/**
+ * Parses a node ID, or the number of nodes.
+ *
+ * @return int The ID
+ */
+int TopologyReader::readNode()
+{
+	const char* first = pos;
+	double value = readNumber();
+	if(value < 0 || value != std::floor(value) 
+			|| value > std::numeric_limits<int>::max() - 1 || (nodes >= 0 && value >= nodes))
+	{
+		pos = first;
+		fail("invalid node ID");
+	}
+
+	return static_cast<int>(value);
+}
+
+/**
+ * Consumes the expected character after any whitespace.
+ *
+ * @param c The expected character
+ */
+void TopologyReader::expect(char c)
+{
+	if(!next(c))
+		fail();
+}
+
+/**
+ * Consumes the character after any whitespace, if it is the given one.
+ *
+ * @param c The character
+ * @return bool The indication of the character being consumed
+ */
+bool TopologyReader::next(char c)
+{
+	skipSpace();
+	if(pos != end && *pos == c)
+	{
+		++pos;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * Skips whitespace.
+ */
+void TopologyReader::skipSpace()
+{
+	while(pos != end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t'))
+		++pos;
+}
+
+/**
+ * Reports an error at the current position.
+ *
+ * @param what The error
+ */
+void TopologyReader::fail(const std::string& what) const
+{
+	throw std::runtime_error(filename + ": " + what + " at offset " 
+			+ std::to_string(pos - data));
+}
@@ -0,0 +1,62 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TOPOLOGYREADER_H
+#define TOPOLOGYREADER_H
+
+#include <string>
+#include <string_view>
+#include <functional>
+#include <stdexcept>
+#include "mappedfile.h"
+
+class TopologyReader
+{
+public:
+	explicit TopologyReader(const std::string&) noexcept(false);
+	TopologyReader(const TopologyReader&) = delete;
+	TopologyReader& operator=(const TopologyReader&) = delete;
+	void read(const std::function<void(int)>&, 
+			const std::function<void(int, int, double)>&) noexcept(false);
+
+private:
+	void readLinks(const std::function<void(int, int, double)>&);
+	void readLink(const std::function<void(int, int, double)>&);
+	void skipValue();
+	std::string_view readString();
+	double readNumber();
+	int readNode();
+	void expect(char);
+	bool next(char);
+	void skipSpace();
+	[[noreturn]] void fail(const std::string& = "malformed JSON") const;
+	std::string filename;
+	MappedFile file;
+	const char* data;
+	const char* pos;
+	const char* end;
+	// Declared number of nodes, bounding the node IDs, or -1 when unknown
+	int nodes;
+};
+
+#endif // TOPOLOGYREADER_H
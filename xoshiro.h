@@ -0,0 +1,93 @@
+/*
+ * AcoPath: Shortest path calculation using Ant Colony Optimization
+ * Copyright (C) 2014-2021 by Constantine Kyriakopoulos
+ * zfox@users.sourceforge.net
+ * @version 0.9.1
+ *
+ * @section LICENSE
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef XOSHIRO_H
+#define XOSHIRO_H
+
+#include <cstdint>
+
+/**
+ * The xoshiro256** generator with 32 bytes of state. Numbered streams of
+ * the same seed are initialised from disjoint outputs of SplitMix64, so
+ * every ant can draw from its own stream regardless of the thread that
+ * runs it.
+ */
+class Xoshiro256
+{
+public:
+	typedef std::uint64_t result_type;
+
+	explicit Xoshiro256(std::uint64_t value = 0, std::uint64_t stream = 0)
+	{
+		seed(value, stream);
+	}
+
+	void seed(std::uint64_t value, std::uint64_t stream = 0)
+	{
+		for(int word = 0; word < 4; ++word)
+			state[word] = mix(value + (stream * 4 + word + 1) * GOLDEN);
+	}
+
+	result_type operator()()
+	{
+		std::uint64_t result = rotate(state[1] * 5, 7) * 9;
+		std::uint64_t shifted = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= shifted;
+		state[3] = rotate(state[3], 45);
+
+		return result;
+	}
+
+	// Uniform number in range [0, 1) out of the 53 high bits
+	double uniform()
+	{
+		return ((*this)() >> 11) * 0x1.0p-53;
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return UINT64_MAX; }
+
+private:
+	static const std::uint64_t GOLDEN = 0x9e3779b97f4a7c15;
+
+	static std::uint64_t rotate(std::uint64_t x, int bits)
+	{
+		return (x << bits) | (x >> (64 - bits));
+	}
+
+	// Finaliser of SplitMix64
+	static std::uint64_t mix(std::uint64_t x)
+	{
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+		return x ^ (x >> 31);
+	}
+
+	std::uint64_t state[4];
+};
+
+#endif // XOSHIRO_H